@@ -3,11 +3,60 @@
 
 #include <array>
 #include <cstdint>
+#include <new>
 #include <optional>
 #include <tuple>
 
+/// the instrumented KeyFunction::operator() is a different function, so the instrumented library
+/// lives in an inline namespace. Translation units which disagree on 
+/// NAMEDPARAMS_ENABLE_INSTRUMENTATION then use different types instead of violating the ODR, and 
+/// passing a KeyFunction between them fails to link. Define it for the whole program.
+#ifdef NAMEDPARAMS_ENABLE_INSTRUMENTATION
+#define _NAMEDPARAMS_BEGIN_INSTRUMENTED inline namespace Instrumented {
+#define _NAMEDPARAMS_END_INSTRUMENTED }
+#else
+#define _NAMEDPARAMS_BEGIN_INSTRUMENTED
+#define _NAMEDPARAMS_END_INSTRUMENTED
+#endif
+
+#ifdef NAMEDPARAMS_ENABLE_INSTRUMENTATION
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#endif
+
+/// inlines the dispatch of named calls even without optimizations, so debug builds do not pay
+/// for a chain of function calls. Define it as "inline" before the include to disable it
+#ifndef NAMEDPARAMS_FORCE_INLINE
+#if defined(__GNUC__) || defined(__clang__)
+#define NAMEDPARAMS_FORCE_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+#define NAMEDPARAMS_FORCE_INLINE __forceinline
+#else
+#define NAMEDPARAMS_FORCE_INLINE inline
+#endif
+#endif
+
+/// qualifies a local pointer which does not alias other pointers, see NamedParams::NoAliasPtr
+#ifndef NAMEDPARAMS_RESTRICT
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define NAMEDPARAMS_RESTRICT __restrict
+#else
+#define NAMEDPARAMS_RESTRICT
+#endif
+#endif
+
+/// std::forward and std::move as casts, they are function calls in unoptimized builds
+#define _NAMEDPARAMS_FORWARD(T, value) static_cast<T&&>(value)
+#define _NAMEDPARAMS_MOVE(value) static_cast<std::remove_reference_t<decltype(value)>&&>(value)
+
 namespace NamedParams 
 {
+_NAMEDPARAMS_BEGIN_INSTRUMENTED
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constexpr container algorithms
@@ -105,6 +154,188 @@ struct IsOptional : public std::false_type {};
 template <class T>
 struct IsOptional<std::optional<T>> : public std::true_type {};
 
+/// OptRef is an optional reference to an object of type T. 
+/// KeyFunction treats it like std::optional, but the object is never copied: 
+/// an absent key gives a null reference, a present key refers to the object of the caller
+template <class T>
+class OptRef
+{
+  public:
+
+    constexpr OptRef()
+      : m_pValue(nullptr)
+    {
+    }
+
+    constexpr OptRef(std::nullopt_t)
+      : m_pValue(nullptr)
+    {
+    }
+
+    constexpr OptRef(T& _value)
+      : m_pValue(&_value)
+    {
+    }
+
+    /// temporaries would dangle after the full-expression, like for std::reference_wrapper
+    OptRef(typename std::remove_const<T>::type&& _value) = delete;
+
+    OptRef(const T&& _value) = delete;
+
+    constexpr bool has_value() const
+    {
+      return m_pValue != nullptr;
+    }
+
+    constexpr explicit operator bool() const
+    {
+      return m_pValue != nullptr;
+    }
+
+    constexpr T& operator*() const
+    {
+      return *m_pValue;
+    }
+
+    constexpr T* operator->() const
+    {
+      return m_pValue;
+    }
+
+    /// returns a pointer to the object, or nullptr if absent
+    constexpr T* get() const
+    {
+      return m_pValue;
+    }
+
+  private:
+
+    T* m_pValue;
+};
+
+template <class T>
+struct IsOptional<OptRef<T>> : public std::true_type {};
+
+/// HintedPtr is a pointer which promises the callee that it is aligned to TAlignment bytes, and
+/// if TNoAlias is true, that no other pointer argument refers to the same memory.
+/// It is built with NamedParams::aligned<N>(ptr) and NamedParams::noalias(ptr) by the caller. 
+/// A callee which takes a HintedPtr parameter only accepts pointers with (at least) the same 
+/// hints at compile time, and gets the alignment through get(). The no-alias promise is kept 
+/// by declaring the local pointer with NAMEDPARAMS_RESTRICT:
+///   double* NAMEDPARAMS_RESTRICT y = _y.get();
+template <class T, size_t TAlignment = alignof(T), bool TNoAlias = false>
+class HintedPtr
+{
+  static_assert(TAlignment >= alignof(T) && (TAlignment & (TAlignment - 1)) == 0,
+    "Pointer alignment has to be a power of two, and at least the alignment of T!");
+
+  public:
+
+    typedef T elementType;
+
+    constexpr static size_t alignment = TAlignment;
+
+    constexpr static bool isNoAlias = TNoAlias;
+
+    /// the caller promises the hints for _ptr
+    constexpr explicit HintedPtr(T* _ptr)
+      : m_ptr(_ptr)
+    {
+    }
+
+    /// hints can only be weakened: a smaller alignment which divides DAlignment, and no-alias 
+    /// only if the source has it
+    template <class D, size_t DAlignment, bool DNoAlias, std::enable_if_t<
+      std::is_convertible<D*,T*>::value && DAlignment % TAlignment == 0 
+      && (DNoAlias || !TNoAlias), bool> = true>
+    constexpr HintedPtr(const HintedPtr<D,DAlignment,DNoAlias>& _other)
+      : m_ptr(_other.get())
+    {
+    }
+
+    /// returns the pointer, the compiler assumes it is aligned
+    NAMEDPARAMS_FORCE_INLINE T* get() const
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<T*>(__builtin_assume_aligned(m_ptr, TAlignment));
+#else
+      return m_ptr;
+#endif
+    }
+
+    /// drops the hints
+    constexpr operator T*() const
+    {
+      return m_ptr;
+    }
+
+    NAMEDPARAMS_FORCE_INLINE T& operator[](size_t _idx) const
+    {
+      return get()[_idx];
+    }
+
+  private:
+
+    T* m_ptr;
+};
+
+template <class T, size_t TAlignment = alignof(T)>
+using AlignedPtr = HintedPtr<T,TAlignment,false>;
+
+template <class T, size_t TAlignment = alignof(T)>
+using NoAliasPtr = HintedPtr<T,TAlignment,true>;
+
+/// promises that _ptr is aligned to TAlignment bytes, e.g. kData = NamedParams::aligned<64>(ptr)
+template <size_t TAlignment, class T>
+constexpr AlignedPtr<T,TAlignment> aligned(T* _ptr)
+{
+  return AlignedPtr<T,TAlignment>(_ptr);
+}
+
+template <size_t TAlignment, class T, size_t DAlignment, bool DNoAlias>
+constexpr HintedPtr<T,(TAlignment > DAlignment) ? TAlignment : DAlignment,DNoAlias> aligned(
+  const HintedPtr<T,DAlignment,DNoAlias>& _ptr)
+{
+  return HintedPtr<T,(TAlignment > DAlignment) ? TAlignment : DAlignment,DNoAlias>(_ptr.get());
+}
+
+/// promises that no other pointer argument of the call refers to the memory of _ptr
+template <class T>
+constexpr NoAliasPtr<T> noalias(T* _ptr)
+{
+  return NoAliasPtr<T>(_ptr);
+}
+
+template <class T, size_t DAlignment, bool DNoAlias>
+constexpr NoAliasPtr<T,DAlignment> noalias(const HintedPtr<T,DAlignment,DNoAlias>& _ptr)
+{
+  return NoAliasPtr<T,DAlignment>(_ptr.get());
+}
+
+/// passed to the callee of a KeyTemplateFunction in place of an omitted optional argument
+struct absent_t
+{
+  constexpr explicit absent_t(int) {}
+};
+
+constexpr inline absent_t absent{0};
+
+/// Checks if type is the marker of an omitted optional argument
+template <class T>
+struct IsAbsent : public std::is_same<typename std::decay<T>::type, absent_t> {};
+
+/// compile-time value of a key, e.g. kMethod = NamedParams::constant<2>. KeyFunction passes
+/// its value, KeyTemplateFunction passes the std::integral_constant itself to the callee
+template <auto V>
+constexpr inline std::integral_constant<decltype(V),V> constant{};
+
+/// Checks if type is a compile-time value passed to a KeyTemplateFunction
+template <class T>
+struct IsConstant : public std::false_type {};
+
+template <class U, U V>
+struct IsConstant<std::integral_constant<U,V>> : public std::true_type {};
+
 /// Default enum in Key class if no special name is chosen
 enum DefaultKeyName 
 {
@@ -122,16 +353,41 @@ struct IsKey : public std::false_type {};
 template <class T, int64_t N, auto E>
 struct IsKey<Key<T,N,E>> : public std::true_type {};
 
+/// Forward declaration for MemberKey class
+template <auto TMember, int64_t N, auto E = DefaultKeyName::UNNAMED_KEY>
+class MemberKey;
+
+template <auto TMember, int64_t N, auto E>
+struct IsKey<MemberKey<TMember,N,E>> : public std::true_type {};
+
+/// Forward declaration for np_update
+template <class TObject, class... Any>
+TObject& np_update(TObject& _object, Any&&... _args);
+
 /// Forward declaration for AssignedKey
-template <class TKey>
+template <class TKey, bool TTemporary = false, class TConstant = void>
 class AssignedKey;
 
 /// Checks if class is an assigned key
 template <class T>
 struct IsAssignedKey : public std::false_type {};
 
+template <class T, bool B, class C>
+struct IsAssignedKey<AssignedKey<T,B,C>> : public std::true_type {};
+
+/// the key type of an assigned key
+template <class T>
+struct AssignedKeyType;
+
+/// Forward declaration for FixedArgument
 template <class T>
-struct IsAssignedKey<AssignedKey<T>> : public std::true_type {};
+struct FixedArgument;
+
+template <class T, bool B, class C>
+struct AssignedKeyType<AssignedKey<T,B,C>>
+{
+  typedef T type;
+};
 
 /// checks if all classes passed to template are Assigned Keys
 template <class... TAssignedKeyPack>
@@ -156,10 +412,28 @@ constexpr inline bool areAllAssignedKeys()
 template <class TFunctionPtr, class... TFunctionKeys>
 class KeyFunction;
 
+template <class TStruct, class... TMemberKeys>
+class KeyAggregate;
+
+template <class... TKeys>
+class OptionSet;
+
+/// Checks if class is an OptionSet
+template <class T>
+struct IsOptionSet : public std::false_type {};
+
+template <class... TKeys>
+struct IsOptionSet<OptionSet<TKeys...>> : public std::true_type {};
+
 /// AssignedKey is the result of assigning(=) a Key to a value.
 /// If the Keytype is a reference, it contains a pointer to the variable 
-/// the key was assigned to. If not, it contains a copy of the variable
-template <class TKey>
+/// the key was assigned to. If not, it contains a copy of the variable.
+/// The key ID is only part of the type, so for trivially copyable values AssignedKey is 
+/// trivially copyable as well, and has the size of the value (or pointer)
+/// TTemporary is true if a const reference key was assigned a temporary
+/// TConstant is the std::integral_constant a key was assigned (e.g. NamedParams::constant<2>),
+/// void for runtime values
+template <class TKey, bool TTemporary, class TConstant>
 class AssignedKey
 {
   static_assert(IsKey<TKey>::value, "AssignedKey has to have Key as a template class!");
@@ -168,80 +442,167 @@ class AssignedKey
 
     typedef typename std::remove_reference<typename TKey::type>::type NoRefType;
 
-    NoRefType* m_pValue;
-    int64_t m_keyID;
+    typedef typename std::conditional<std::is_reference<typename TKey::type>::value, 
+      NoRefType*, typename TKey::type>::type StorageType;
+
+    StorageType m_value;
 
     AssignedKey() = delete;
 
-    AssignedKey(NoRefType* _pValue, int64_t _keyID)
-      : m_pValue(_pValue)
-      , m_keyID(_keyID)
+    NAMEDPARAMS_FORCE_INLINE explicit AssignedKey(StorageType&& _value)
+      : m_value(_NAMEDPARAMS_MOVE(_value))
     {
     }
 
     template <class T, std::enable_if_t<std::is_reference<T>::value, int> = 0>
-    static AssignedKey build(T _value)
+    NAMEDPARAMS_FORCE_INLINE static AssignedKey build(T _value)
     {
-      return AssignedKey(&_value, TKey::ID);
+      return AssignedKey(&_value);
     }
 
     template <class T, std::enable_if_t<!std::is_reference<T>::value, bool> = true>
-    static AssignedKey build(T _value)
+    NAMEDPARAMS_FORCE_INLINE static AssignedKey build(T _value)
     {
-      return AssignedKey(new T(_value), TKey::ID);
+      return AssignedKey(_NAMEDPARAMS_MOVE(_value));
     }
 
     AssignedKey(const AssignedKey& _input) = delete;
 
-    AssignedKey(AssignedKey&& _input)
+    AssignedKey(AssignedKey&& _input) = default;
+
+    /// drops the temporary and constant markers, calls declared with NAMEDPARAMS_DECLARE_CALL 
+    /// take AssignedKey<TKey>
+    template <bool DTemporary, class DConstant>
+    NAMEDPARAMS_FORCE_INLINE explicit AssignedKey(AssignedKey<TKey,DTemporary,DConstant>&& _input)
+      : m_value(_NAMEDPARAMS_MOVE(_input.m_value))
     {
-      m_pValue = _input.m_pValue;
-      m_keyID = _input.m_keyID;
-      _input.m_pValue = nullptr;
     }
 
     AssignedKey& operator=(const AssignedKey& _input) = delete;
 
-    AssignedKey& operator=(AssignedKey&& _input) 
-    {
-      m_pValue = _input.m_pValue;
-      m_keyID = _input.m_keyID;
-      _input.m_pValue = nullptr;
-      return *this;
-    }
+    AssignedKey& operator=(AssignedKey&& _input) = default;
 
-    NoRefType* getValue() 
+    NAMEDPARAMS_FORCE_INLINE NoRefType* getValue() 
     {
-      return m_pValue;
+      if constexpr (std::is_reference<typename TKey::type>::value)
+      {
+        return m_value;
+      }
+      else 
+      {
+        return &m_value;
+      }
     }
 
-    int64_t getKeyID() const
+    constexpr static int64_t getKeyID()
     {
-      return m_keyID;
+      return TKey::ID;
     }
 
     typedef TKey keyType;
 
+    constexpr static bool isTemporary = TTemporary;
+
+    template <class DKey, bool DTemporary, class DConstant>
+    friend class AssignedKey;
+
     template <typename D, int64_t ID, auto Enum>
     friend class Key;
 
+    template <auto TMember, int64_t ID, auto Enum>
+    friend class MemberKey;
+
+    template <class TObject, class... Any>
+    friend TObject& np_update(TObject& _object, Any&&... _args);
+
     template <class TFunctionPtr, class... TFunctionKeys>
     friend class KeyFunction;
 
+    template <class TStruct, class... TMemberKeys>
+    friend class KeyAggregate;
+
+    template <class T>
+    friend struct FixedArgument;
+
+    template <class... TKeys>
+    friend class OptionSet;
+
+  public:
+
+    ~AssignedKey() = default;
+
+};
+
+/// a named parameter which is passed to several calls, e.g. to every grid point of a sweep,
+/// every row of NamedColumns::apply or every node of a TaskGraph
+template <class T>
+struct FixedArgument
+{
+  static_assert(IsAssignedKey<T>::value, "Only named parameters can be passed to every call!");
+
+  typedef typename AssignedKeyType<T>::type KeyType;
+
+  /// assigns the key again, so by-value arguments are copied for each call
+  NAMEDPARAMS_FORCE_INLINE static auto get(T& _argument)
+  {
+    return KeyType() = *_argument.getValue();
+  }
+};
+
+/// KeyValues is the result of assigning a braced list of values to a Key, e.g.
+/// kScaling = {0.5, 1.0}. It is only accepted by NamedParams::sweep.
+/// It points to the temporary array of the list, so it is only valid until the end of the 
+/// full-expression
+template <class TKey>
+class KeyValues
+{
   public:
 
-    ~AssignedKey()
+    typedef typename std::remove_cv<typename std::remove_reference<typename TKey::type>::type>::type
+      ValueType;
+
+    typedef TKey keyType;
+
+    KeyValues(const ValueType* _values, size_t _size)
+      : m_values(_values)
+      , m_size(_size)
     {
-      if (m_pValue && !std::is_reference<typename TKey::type>::value) 
-      {
-        delete m_pValue;
-        m_pValue = nullptr;
-      }
+    }
+
+    const ValueType& operator[](size_t _idx) const
+    {
+      return m_values[_idx];
+    }
+
+    size_t size() const
+    {
+      return m_size;
+    }
+
+    const ValueType* begin() const
+    {
+      return m_values;
+    }
 
+    const ValueType* end() const
+    {
+      return m_values + m_size;
     }
 
+  private:
+
+    const ValueType* m_values;
+
+    size_t m_size;
 };
 
+/// Checks if class is a list of key values
+template <class T>
+struct IsKeyValues : public std::false_type {};
+
+template <class TKey>
+struct IsKeyValues<KeyValues<TKey>> : public std::true_type {};
+
 enum class ErrorType
 {
   NONE = 0,
@@ -253,7 +614,8 @@ enum class ErrorType
   KEY_HAS_WRONG_TYPE = 6,
   COULD_NOT_CONVERT_KEY_TYPE_TO_ARGUMENT_TYPE = 7,
   INCORRECT_NUMBER_OF_KEYS_PASSED_TO_KEYFUNCTION = 8,
-  SAME_KEY_PASSED_MORE_THAN_ONCE_KEYFUNCTION = 9
+  SAME_KEY_PASSED_MORE_THAN_ONCE_KEYFUNCTION = 9,
+  TEMPORARY_BOUND_TO_COROUTINE_REFERENCE = 10
 };
 
 /// utility function which outputs some type of message in the compiler output
@@ -270,6 +632,7 @@ constexpr void failWithMessage()
   static_assert((error != ErrorType::KEY_HAS_WRONG_TYPE));
   static_assert((error != ErrorType::COULD_NOT_CONVERT_KEY_TYPE_TO_ARGUMENT_TYPE));
   static_assert((error != ErrorType::INCORRECT_NUMBER_OF_KEYS_PASSED_TO_KEYFUNCTION));
+  static_assert((error != ErrorType::TEMPORARY_BOUND_TO_COROUTINE_REFERENCE));
 }
 
 //template <typename T>
@@ -279,739 +642,2725 @@ constexpr void failWithMessage()
 //}
 
 
-/// The Key class allows to define named parameters that are passed to the KeyFunction object.
-/// Keys can be reused from one function to another.
-/// Keys in the same function should not have the same UNIQUE_ID, or everything
-/// will break down.
-/// The Key class does not keep any record of the variable it is assigned to,
-/// but delegates the work to AssignedKey.
-template <typename T, int64_t UNIQUE_ID, auto E> 
-class Key
+#ifdef NAMEDPARAMS_ENABLE_INSTRUMENTATION
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Call instrumentation
+///  Only compiled if NAMEDPARAMS_ENABLE_INSTRUMENTATION is defined. Each KeyFunction type keeps 
+///  one block of counters per thread, which is only written by that thread.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// number of latency buckets, bucket i counts the calls which took less than 2^i ns
+constexpr int NB_LATENCY_BUCKETS = 40;
+
+/// number of different presence masks which are recorded per function and thread
+constexpr int NB_PRESENCE_MASKS = 16;
+
+/// returns the name of T as given by the compiler
+template <class T>
+constexpr std::string_view getTypeName()
 {
-  static_assert(UNIQUE_ID >= 0, "Key has to have an ID greater or equal zero!");
+  std::string_view name = __PRETTY_FUNCTION__;
+  const size_t start = name.find("T = ");
+  if (start == std::string_view::npos)
+  {
+    return name;
+  }
+  name.remove_prefix(start + 4);
+  const size_t end = name.find_first_of(";]");
+  return (end == std::string_view::npos) ? name : name.substr(0, end);
+}
 
-  public:
-    Key() {}
+/// counters of a single function for a single thread
+struct ThreadCallCounters
+{
+  std::atomic<uint64_t> nbCalls{0};
+  std::atomic<uint64_t> totalNs{0};
+  std::array<std::atomic<uint64_t>, NB_LATENCY_BUCKETS> latencyHistogram{};
+  std::array<std::atomic<uint64_t>, NB_PRESENCE_MASKS> presenceMasks{};
+  std::array<std::atomic<uint64_t>, NB_PRESENCE_MASKS> presenceCounts{};
+  std::atomic<uint64_t> nbOtherPresenceMasks{0};
+};
 
-    Key(const Key& _other) = delete;
+/// accumulated counters of a single function
+struct CallStatistics
+{
+  std::string_view name;
+  uint64_t nbCalls;
+  uint64_t totalNs;
+  std::array<uint64_t, NB_LATENCY_BUCKETS> latencyHistogram;
+  std::vector<std::pair<uint64_t,uint64_t>> presenceCounts; // (mask, number of calls)
+  uint64_t nbOtherPresenceMasks; // calls with masks that did not fit into the table
+  size_t nbThreadBlocks; // counter blocks, at most the number of threads alive at the same time
+};
 
-    Key(Key&& _other) = delete;
+/// increment a counter only written by the current thread, no read-modify-write needed
+inline void _increment(std::atomic<uint64_t>& _counter, uint64_t _value = 1)
+{
+  _counter.store(_counter.load(std::memory_order_relaxed) + _value, std::memory_order_relaxed);
+}
+
+/// all counters of a single function
+class FunctionCallCounters
+{
+  public:
 
-    auto operator=(T _any) const
+    FunctionCallCounters(std::string_view _name)
+      : m_name(_name)
     {
-      auto k = AssignedKey<Key>::template build<T>(_any);
-      return k;
     }
 
-    typedef T type;
+    /// returns a counter block for a new thread: the block of a finished thread if there is one,
+    /// a new block otherwise. The block keeps its counts and lives as long as the function 
+    /// counters
+    ThreadCallCounters* acquireThread()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_freeThreads.empty())
+      {
+        ThreadCallCounters* counters = m_freeThreads.back();
+        m_freeThreads.pop_back();
+        return counters;
+      }
+      m_threads.push_back(std::make_unique<ThreadCallCounters>());
+      return m_threads.back().get();
+    }
 
-    static inline const int64_t ID = UNIQUE_ID;
+    /// called when the thread of _counters exits, the block is reused by the next new thread
+    void releaseThread(ThreadCallCounters* _counters)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_freeThreads.push_back(_counters);
+    }
 
-    static inline auto const name = E;
+    /// sums up the counters of all threads
+    CallStatistics snapshot() const
+    {
+      CallStatistics stats = {m_name, 0, 0, {}, {}, 0, 0};
 
-};
+      std::lock_guard<std::mutex> lock(m_mutex);
+      stats.nbThreadBlocks = m_threads.size();
+      for (const auto& thread : m_threads)
+      {
+        stats.nbCalls += thread->nbCalls.load(std::memory_order_relaxed);
+        stats.totalNs += thread->totalNs.load(std::memory_order_relaxed);
+        stats.nbOtherPresenceMasks += thread->nbOtherPresenceMasks.load(std::memory_order_relaxed);
 
+        for (int i = 0; i < NB_LATENCY_BUCKETS; ++i)
+        {
+          stats.latencyHistogram[i] += thread->latencyHistogram[i].load(std::memory_order_relaxed);
+        }
 
-/// FunctionTraits taken and adapted from "https://functionalcpp.wordpress.com/2013/08/05/function-traits/"
-/// A helper class to get the variable types of a function
-template <typename T>
-struct FunctionTraitsBase;
+        for (int i = 0; i < NB_PRESENCE_MASKS; ++i)
+        {
+          // count is written after the mask, a zero count marks an unused slot 
+          const uint64_t count = thread->presenceCounts[i].load(std::memory_order_acquire);
+          if (count == 0)
+          {
+            break;
+          }
+          const uint64_t mask = thread->presenceMasks[i].load(std::memory_order_relaxed);
 
-template <typename T> 
-struct FunctionTraits;  
+          auto iter = stats.presenceCounts.begin();
+          for (; iter != stats.presenceCounts.end() && iter->first != mask; ++iter) {}
 
-template<typename R, typename ...Args> 
-struct FunctionTraitsBase<R(Args...)>
-{
-    static const size_t nbArgs = sizeof...(Args);
+          if (iter == stats.presenceCounts.end())
+          {
+            stats.presenceCounts.emplace_back(mask, count);
+          }
+          else 
+          {
+            iter->second += count;
+          }
+        }
+      }
 
-    typedef R ResultType;
+      return stats;
+    }
 
-    template <size_t i>
-    struct arg
+    /// sets all counters to zero, calls recorded at the same time may be lost
+    void reset()
     {
-        typedef typename std::tuple_element<i, std::tuple<Args...>>::type type;
-    };
-};
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto& thread : m_threads)
+      {
+        thread->nbCalls.store(0, std::memory_order_relaxed);
+        thread->totalNs.store(0, std::memory_order_relaxed);
+        thread->nbOtherPresenceMasks.store(0, std::memory_order_relaxed);
+        for (auto& bucket : thread->latencyHistogram)
+        {
+          bucket.store(0, std::memory_order_relaxed);
+        }
+        for (auto& count : thread->presenceCounts)
+        {
+          count.store(0, std::memory_order_relaxed);
+        }
+      }
+    }
 
-template <class R, typename ...Args>
-struct FunctionTraits<R(Args...)> : public FunctionTraitsBase<R(Args...)> 
-{
-  typedef void ClassType;
-};
+  private:
 
-template <class C, class R, typename... Args>
-struct FunctionTraits<R(C::*)(Args...)> : public FunctionTraitsBase<R(Args...)>
-{
-  typedef C ClassType;
+    std::string_view m_name;
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadCallCounters>> m_threads;
+    std::vector<ThreadCallCounters*> m_freeThreads;
 };
 
-template <class C, class R, typename... Args>
-struct FunctionTraits<R(C::*)(Args...)const> : public FunctionTraitsBase<R(Args...)>
+/// the counter block of one function held by the current thread, returned when the thread exits
+class ThreadCountersLease
 {
-  typedef C ClassType;
-};
+  public:
 
-template <class T, bool B>
-struct _RemoveConstIfNotReferenceImpl;
+    explicit ThreadCountersLease(FunctionCallCounters& _function)
+      : m_function(_function)
+      , m_counters(_function.acquireThread())
+    {
+    }
 
-template <class T>
-struct _RemoveConstIfNotReferenceImpl<T,false>
-{
-  typedef T type;
-};
+    ThreadCountersLease(const ThreadCountersLease&) = delete;
 
-template <class T>
-struct _RemoveConstIfNotReferenceImpl<T,true>
-{
-  typedef typename std::remove_const<T>::type type;
-};
+    ThreadCountersLease& operator=(const ThreadCountersLease&) = delete;
 
-template <class T>
-struct RemoveConstIfNotReference
-{
-  typedef typename _RemoveConstIfNotReferenceImpl<T,!std::is_reference<T>::value>::type type;
+    ~ThreadCountersLease()
+    {
+      m_function.releaseThread(m_counters);
+    }
+
+    ThreadCallCounters& get() const
+    {
+      return *m_counters;
+    }
+
+  private:
+
+    FunctionCallCounters& m_function;
+    ThreadCallCounters* m_counters;
 };
 
-/// returns true if argument types to function are all the same as the tyes contained in the keys
-template <class TFunctionPtr, class... TFunctionKeys, size_t... Is>
-constexpr inline int KeyTypesAreValid(std::index_sequence<Is...> const &)
+/// global access to the counters of all instrumented functions
+class Instrumentation
 {
-  // passing const by value to a function has no effect, and so decays to non-const
-  // in function pointer. We therefore also remove const here
-  using KeyTuple = std::tuple<typename RemoveConstIfNotReference<
-    typename TFunctionKeys::type>::type...>;
-  using TFunctionTraits = FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type>;
+  public:
 
-  constexpr std::array<bool,sizeof...(TFunctionKeys)> keyTypesCompare = {
-    std::is_same<
-      typename std::tuple_element<Is, KeyTuple>::type, 
-      typename TFunctionTraits::template arg<Is>::type
-    >::value...};
+    /// returns the counters of function type TFunction for the calling thread
+    template <class TFunction>
+    static ThreadCallCounters& getThreadCounters()
+    {
+      static FunctionCallCounters* functionCounters = addFunction(getTypeName<TFunction>());
+      thread_local ThreadCountersLease threadCounters(*functionCounters);
+      return threadCounters.get();
+    }
 
-  for (int i = 0; i < (int)sizeof...(TFunctionKeys); ++i)
-  {
-    if (!keyTypesCompare[i])
+    /// records one call which took _ns nanoseconds
+    static void record(ThreadCallCounters& _counters, uint64_t _ns, uint64_t _presenceMask)
     {
-      return i;
+      _increment(_counters.nbCalls);
+      _increment(_counters.totalNs, _ns);
+
+      int bucket = 0;
+      while (bucket < NB_LATENCY_BUCKETS - 1 && (_ns >> bucket) != 0)
+      {
+        ++bucket;
+      }
+      _increment(_counters.latencyHistogram[bucket]);
+
+      for (int i = 0; i < NB_PRESENCE_MASKS; ++i)
+      {
+        const uint64_t count = _counters.presenceCounts[i].load(std::memory_order_relaxed);
+        if (count == 0)
+        {
+          _counters.presenceMasks[i].store(_presenceMask, std::memory_order_relaxed);
+          _counters.presenceCounts[i].store(1, std::memory_order_release);
+          return;
+        }
+        if (_counters.presenceMasks[i].load(std::memory_order_relaxed) == _presenceMask)
+        {
+          _increment(_counters.presenceCounts[i]);
+          return;
+        }
+      }
+
+      _increment(_counters.nbOtherPresenceMasks);
     }
-  }
 
-  return -1;
+    /// returns the accumulated counters of all functions called so far
+    static std::vector<CallStatistics> snapshot()
+    {
+      std::vector<CallStatistics> out;
+      Registry& registry = getRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      for (const auto& function : registry.functions)
+      {
+        out.push_back(function->snapshot());
+      }
+      return out;
+    }
 
-}
+    /// sets the counters of all functions to zero
+    static void reset()
+    {
+      Registry& registry = getRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      for (auto& function : registry.functions)
+      {
+        function->reset();
+      }
+    }
 
-/// returns the position of the first key with the same ID, else -1
-template <class... TFunctionKeys>
-constexpr inline int MultipleIdenticalKeys()
-{
-  std::array<int64_t, sizeof...(TFunctionKeys)> keyIDs = { TFunctionKeys::ID... };
-  _sort(keyIDs.begin(), keyIDs.end());
-  for (int i = 1; i < (int)sizeof...(TFunctionKeys); ++i) 
-  {
-    if (keyIDs[i-1] == keyIDs[i])
+    /// writes a human readable summary of all counters
+    static void dump(std::ostream& _out)
     {
-      return i-1;
+      for (const CallStatistics& stats : snapshot())
+      {
+        _out << stats.name << "\n";
+        _out << "  calls: " << stats.nbCalls << ", total: " << stats.totalNs << " ns, mean: " 
+             << (stats.nbCalls ? stats.totalNs / stats.nbCalls : 0) << " ns\n";
+
+        _out << "  latency:";
+        for (int i = 0; i < NB_LATENCY_BUCKETS; ++i)
+        {
+          if (stats.latencyHistogram[i] != 0)
+          {
+            _out << " <2^" << i << "ns: " << stats.latencyHistogram[i];
+          }
+        }
+        _out << "\n";
+
+        _out << "  presence masks:";
+        for (const auto& mask : stats.presenceCounts)
+        {
+          _out << " 0x" << std::hex << mask.first << std::dec << ": " << mask.second;
+        }
+        if (stats.nbOtherPresenceMasks != 0)
+        {
+          _out << " other: " << stats.nbOtherPresenceMasks;
+        }
+        _out << "\n";
+      }
     }
-  }
-  return -1;
-} 
 
-/// groups all functions from above to check if keys are valid for the given function
-template <class TFunctionPtr, class... TFunctionKeys>
-constexpr inline bool KeyFunctionTemplateIsValid() 
-{
-  // Check if TFunctionPtr is really a (member) function pointer
-  // This is necessary because templates are checked for both constructors
-  // in KeyFunction, even if only one is enabled. This leads to errors 
-  // in this function. 
-  if constexpr (std::is_function<typename std::remove_pointer<TFunctionPtr>::type>::value
-    || std::is_member_function_pointer<TFunctionPtr>::value)
-  {
-    constexpr int nbFunctionArgs = FunctionTraits< 
-      typename std::remove_pointer<TFunctionPtr>::type>::nbArgs;
+  private:
 
-    constexpr int nbKeys = sizeof...(TFunctionKeys);
-    if constexpr (nbFunctionArgs != nbKeys)
+    struct Registry
     {
-      failWithMessage<
-        ErrorType::INCORRECT_NUMBER_OF_KEYS_PASSED_TO_KEYFUNCTION,
-        nbFunctionArgs,nbKeys>();
-      return false;
+      std::mutex mutex;
+      std::vector<std::unique_ptr<FunctionCallCounters>> functions;
+    };
+
+    static Registry& getRegistry()
+    {
+      static Registry registry;
+      return registry;
     }
 
-    constexpr int invalidKey = KeyTypesAreValid<TFunctionPtr,TFunctionKeys...>(
-      std::make_index_sequence<nbFunctionArgs>());
-    if constexpr (invalidKey >= 0)
+    static FunctionCallCounters* addFunction(std::string_view _name)
     {
-      failWithMessage<
-        ErrorType::KEY_HAS_WRONG_TYPE,
-        std::tuple_element<invalidKey, std::tuple<TFunctionKeys...>>::type::name>();
-      return false;
+      Registry& registry = getRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.functions.push_back(std::make_unique<FunctionCallCounters>(_name));
+      return registry.functions.back().get();
     }
 
-    constexpr int duplicateKey = MultipleIdenticalKeys<TFunctionKeys...>();
-    if constexpr (duplicateKey >= 0)
+};
+
+/// measures the time between construction and destruction and records it for TFunction
+template <class TFunction>
+class ScopedCallTimer
+{
+  public:
+
+    explicit ScopedCallTimer(uint64_t _presenceMask)
+      : m_presenceMask(_presenceMask)
+      , m_start(std::chrono::steady_clock::now())
     {
-      failWithMessage<ErrorType::SAME_KEY_PASSED_MORE_THAN_ONCE_KEYFUNCTION, duplicateKey>();
-      return false;
     }
 
-    // TODO: ENFORCE OPTIONAL KEYS AFTER NON-OPTIONAL KEYS (?)
-    return true;
-  }
+    ScopedCallTimer(const ScopedCallTimer&) = delete;
 
-  return false;
+    ScopedCallTimer& operator=(const ScopedCallTimer&) = delete;
 
-}
+    ~ScopedCallTimer()
+    {
+      const auto end = std::chrono::steady_clock::now();
+      const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count();
+      Instrumentation::record(Instrumentation::getThreadCounters<TFunction>(), ns, m_presenceMask);
+    }
 
-/// KeyFunction is a class which wraps around a (member) function pointer
-/// operator()() lets you call the function using positiionals, named parameters and optionals
-template <class TFunctionPtr, class... TFunctionKeys>
-class KeyFunction
-{
   private:
 
-    typedef FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type> KeyFunctionTraits;
+    uint64_t m_presenceMask;
+    std::chrono::steady_clock::time_point m_start;
+};
 
-    typename KeyFunctionTraits::ClassType* m_classPtr;
+#endif // NAMEDPARAMS_ENABLE_INSTRUMENTATION
 
-    TFunctionPtr m_baseFunction; 
+/// The Key class allows to define named parameters that are passed to the KeyFunction object.
+/// Keys can be reused from one function to another.
+/// Keys in the same function should not have the same UNIQUE_ID, or everything
+/// will break down.
+/// The Key class does not keep any record of the variable it is assigned to,
+/// but delegates the work to AssignedKey.
+template <typename T, int64_t UNIQUE_ID, auto E> 
+class Key
+{
+  static_assert(UNIQUE_ID >= 0, "Key has to have an ID greater or equal zero!");
 
-    constexpr inline static std::array<int64_t, KeyFunctionTraits::nbArgs> m_functionKeyIDs = { 
-      TFunctionKeys::ID... };
+  public:
+    constexpr Key() {}
 
-    // placeholder for unused optional arguments
-    std::nullopt_t* m_nullOpt;
+    Key(const Key& _other) = delete;
 
-  public:
+    Key(Key&& _other) = delete;
 
-    /// constructor for non-member, or static member functions
-    template <class DFunctionPtr, class... DFunctionKeys,
-      std::enable_if_t<
-        !std::is_member_function_pointer<DFunctionPtr>::value
-        && KeyFunctionTemplateIsValid<DFunctionPtr,DFunctionKeys...>()
-      , bool> = true>
-    KeyFunction(DFunctionPtr _function, [[maybe_unused]] const DFunctionKeys&... _keys)
-      : m_classPtr(nullptr)
-      , m_baseFunction(_function)
-      , m_nullOpt(new std::nullopt_t(std::nullopt))
+    NAMEDPARAMS_FORCE_INLINE auto operator=(T _any) const
     {
+      return AssignedKey<Key>::template build<T>(_NAMEDPARAMS_FORWARD(T, _any));
     }
 
-    /// constructor for non-static member functions which additionally accepts a pointer to 
-    /// an instance of its class
-    template <class DFunctionPtr, class... DFunctionKeys, 
-      std::enable_if_t<
-        std::is_member_function_pointer<DFunctionPtr>::value
-        && KeyFunctionTemplateIsValid<DFunctionPtr,DFunctionKeys...>()
-      , bool> = true>
-    KeyFunction(typename KeyFunctionTraits::ClassType* _classPtr, DFunctionPtr _function, 
-      [[maybe_unused]] const DFunctionKeys&... _keys)
-      : m_classPtr(_classPtr)
-      , m_baseFunction(_function)
-      , m_nullOpt(new std::nullopt_t(std::nullopt))
+    /// const reference keys remember if they were assigned a temporary
+    template <class D = T, std::enable_if_t<std::is_lvalue_reference<D>::value 
+      && std::is_const<typename std::remove_reference<D>::type>::value, bool> = true>
+    NAMEDPARAMS_FORCE_INLINE auto operator=(typename std::remove_reference<D>::type&& _any) const
     {
+      return AssignedKey<Key,true>::template build<T>(_any);
     }
 
-    ~KeyFunction() 
+    /// compile-time constants, e.g. kMethod = NamedParams::constant<2>. The value is stored like 
+    /// a runtime value, the constant is part of the type. Only for keys which are not references
+    template <class U, U V, class D = T, std::enable_if_t<!std::is_reference<D>::value 
+      && std::is_constructible<D,U>::value, bool> = true>
+    NAMEDPARAMS_FORCE_INLINE auto operator=(std::integral_constant<U,V>) const
     {
-      delete m_nullOpt;
+      return AssignedKey<Key,false,std::integral_constant<U,V>>::template build<T>(T(V));
     }
 
-    TFunctionPtr getBaseFunction() const
+    /// braced lists of two or more values, e.g. for NamedParams::sweep. A single value in 
+    /// braces still calls operator=(T). Not available for non-const reference keys
+    template <size_t N, class D = T, std::enable_if_t<(!std::is_lvalue_reference<D>::value 
+      || std::is_const<typename std::remove_reference<D>::type>::value), bool> = true>
+    KeyValues<Key> operator=(
+      const typename std::remove_cv<typename std::remove_reference<D>::type>::type (&_values)[N]) 
+      const
     {
-      return m_baseFunction;
+      return KeyValues<Key>(_values, N);
     }
 
-    /// struct used in constexpr functions which encapsulates some info about the error
-    struct EvalReturn
-    {
-      ErrorType errorType;
-      int id;
-      int isFuncID; // wether id refers to TFunctionKeys (0), Any (pos) or None (neg)
-    };
+    typedef T type;
 
-    /// reserved negative key IDs to complement the positive "real" key IDs
-    enum KeyIdType 
-    {
-      POSITIONAL = -1,
-      UNKNOWN = -2,
-      ABSENT = -3
-    };
+    static inline const int64_t ID = UNIQUE_ID;
 
-    // get local key IDs for passed arguments
-    // unknown arguments are given ID = -2
-    // positional arguments are given ID = -1
-    // named arguments are assigned its position in the function argument list
-    template <class... Any>
-    constexpr inline static std::array<int64_t,sizeof...(Any)> getLocalKeyIDs()
-    {
-      constexpr int nbPassedArgs = sizeof...(Any);
-      std::array<int64_t, nbPassedArgs> passedKeyIDs = { GetArgumentID<Any>::ID... };
-      std::array<int64_t, nbPassedArgs> passedLocalKeyIDs = {};
-      
-      for (int i = 0; i < nbPassedArgs; ++i) 
-      {
-        if (passedKeyIDs[i] < 0)
-        {
-          passedLocalKeyIDs[i] = KeyIdType::POSITIONAL;
-          continue;
-        }
+    static inline auto const name = E;
 
-        auto iter = _find(m_functionKeyIDs.begin(), m_functionKeyIDs.end(), passedKeyIDs[i]);
+};
 
-        if (iter == m_functionKeyIDs.end())
-        {
-          passedLocalKeyIDs[i] = KeyIdType::UNKNOWN;
-        }
-        else 
-        {
-          int64_t idx = iter - m_functionKeyIDs.begin();
-          passedLocalKeyIDs[i] = idx;
-        }
+/// AssignedKeys of small values and references are passed in registers
+/// (trivially copyable, not larger than the value itself)
+template <class T>
+constexpr inline bool _assignedKeyIsRegisterPassable()
+{
+  typedef AssignedKey<Key<T,0>> TAssignedKey;
+  return std::is_trivially_copyable<TAssignedKey>::value
+    && std::is_trivially_destructible<TAssignedKey>::value
+    && sizeof(TAssignedKey) == sizeof(typename std::conditional<std::is_reference<T>::value, 
+      void*, T>::type);
+}
 
-      }
+static_assert(_assignedKeyIsRegisterPassable<int>(), "AssignedKey<int> is not register passable!");
+static_assert(_assignedKeyIsRegisterPassable<double>(), 
+  "AssignedKey<double> is not register passable!");
+static_assert(_assignedKeyIsRegisterPassable<const char*>(), 
+  "AssignedKey<const char*> is not register passable!");
+static_assert(_assignedKeyIsRegisterPassable<std::optional<int>>(), 
+  "AssignedKey<std::optional<int>> is not register passable!");
+static_assert(_assignedKeyIsRegisterPassable<float&>(), "AssignedKey<float&> is not register passable!");
+static_assert(_assignedKeyIsRegisterPassable<const int&>(), 
+  "AssignedKey<const int&> is not register passable!");
+
+/// returns the position of the key with the ID of TKey in TKeys, or sizeof...(TKeys) if there 
+/// is none. Keys are matched by ID, so cv-qualified keys match as well
+template <class TKey, class... TKeys>
+constexpr size_t getKeyIndex()
+{
+  constexpr std::array<int64_t,sizeof...(TKeys) + 1> keyIDs = 
+  { 
+    TKeys::ID..., -1 
+  };
 
-      return passedLocalKeyIDs;
+  for (size_t i = 0; i < sizeof...(TKeys); ++i)
+  {
+    if (keyIDs[i] == TKey::ID)
+    {
+      return i;
     }
+  }
 
-    /// sort the passed arguments according to order of functionKeys
-    /// do it here in this function, so we do not need to do it at runtime
-    /// returns a sorted array where array[idx] gives the original position of 
-    /// the passed argument
-    template <class... Any>
-    constexpr inline static std::array<int64_t,sizeof...(Any)> getSortedIndices(
-      const std::array<int64_t,sizeof...(Any)>& localKeyIDs)
+  return sizeof...(TKeys);
+}
+
+/// the indices in TIndices which are smaller than TEnd, in their order, as an index_sequence.
+/// Selects a subset of keys, indices of TEnd or larger mark the keys which are left out
+template <size_t TEnd, size_t... TIndices>
+struct SelectedIndices
+{
+  constexpr static size_t nbSelected = (size_t(TIndices < TEnd) + ... + 0);
+
+  constexpr static std::array<size_t,nbSelected + 1> getSelected()
+  {
+    constexpr std::array<size_t,sizeof...(TIndices) + 1> indices = { TIndices..., TEnd };
+
+    std::array<size_t,nbSelected + 1> selected = {};
+    size_t nb = 0;
+    for (size_t i = 0; i < sizeof...(TIndices); ++i)
     {
-      constexpr int nbPassedKeys = sizeof...(Any);
-      std::array<int64_t, nbPassedKeys> indices = {};
-      for (int i = 0; i < nbPassedKeys; ++i)
+      if (indices[i] < TEnd)
       {
-        indices[i] = i;
+        selected[nb++] = indices[i];
       }
+    }
+    return selected;
+  }
 
-      _sort(indices.begin(), indices.end(), 
-        [&](const int64_t a, const int64_t b)
-        {
-          return localKeyIDs[a] < localKeyIDs[b];
+  constexpr static std::array<size_t,nbSelected + 1> selected = getSelected();
+
+  template <size_t... Is>
+  static auto getSequence(std::index_sequence<Is...> const &)
+    -> std::index_sequence<selected[Is]...>;
+
+  typedef decltype(getSequence(std::make_index_sequence<nbSelected>{})) Sequence;
+};
+
+/// OptionSet stores the values of optional keys, e.g. a stored configuration of a function with 
+/// many optionals, in less space than the same std::optionals. The presence flags are packed 
+/// into a single bitmask, and the values are ordered by decreasing alignment, so there is no 
+/// padding between them. OptionSet can be passed to a KeyFunction as a whole, where it is 
+/// expanded into the individual optionals. Keys which are passed explicitly in the same call 
+/// take precedence over the values of the set.
+template <class... TKeys>
+class OptionSet
+{
+  static_assert(sizeof...(TKeys) > 0 && sizeof...(TKeys) <= 64, 
+    "OptionSet has to have between 1 and 64 keys!");
+
+  public:
+
+    constexpr static size_t nbKeys = sizeof...(TKeys);
+
+    /// the key at position Idx
+    template <size_t Idx>
+    using KeyType = typename std::remove_cv<
+      typename std::tuple_element<Idx, std::tuple<TKeys...>>::type>::type;
+
+    /// the type of the value of an optional key
+    template <class TKey>
+    using ValueType = typename std::remove_cv<
+      typename std::remove_reference<typename TKey::type>::type>::type::value_type;
+
+    /// smallest unsigned integer with a bit for each key
+    typedef typename std::conditional<(nbKeys <= 8), uint8_t, 
+      typename std::conditional<(nbKeys <= 16), uint16_t, 
+      typename std::conditional<(nbKeys <= 32), uint32_t, uint64_t>::type>::type>::type MaskType;
+
+  private:
+
+    template <class TKey>
+    struct IsOptionKey : public std::bool_constant<
+      std::is_same<typename std::remove_cv<typename std::remove_reference<
+        typename TKey::type>::type>::type, std::optional<ValueType<TKey>>>::value
+      && (!std::is_reference<typename TKey::type>::value 
+        || std::is_const<typename std::remove_reference<typename TKey::type>::type>::value)> {};
+
+    static_assert(std::conjunction<IsOptionKey<TKeys>...>::value, 
+      "Only keys of type std::optional (or a const reference to it) can be part of an OptionSet!");
+
+    constexpr static std::array<size_t,nbKeys> s_sizes = { sizeof(ValueType<TKeys>)... };
+
+    constexpr static std::array<size_t,nbKeys> s_alignments = { alignof(ValueType<TKeys>)... };
+
+    constexpr static size_t getMaxAlignment()
+    {
+      size_t alignment = 1;
+      for (size_t keyAlignment : s_alignments)
+      {
+        alignment = (keyAlignment > alignment) ? keyAlignment : alignment;
+      }
+      return alignment;
+    }
+
+    constexpr static size_t s_maxAlignment = getMaxAlignment();
+
+    /// byte offsets of the values, in order of decreasing alignment. Sizes are multiples of 
+    /// the alignment, so each value is aligned if the first one is
+    constexpr static std::array<size_t,nbKeys + 1> getOffsets()
+    {
+      std::array<size_t,nbKeys + 1> offsets = {};
+      size_t offset = 0;
+      for (size_t alignment = s_maxAlignment; alignment > 0; alignment /= 2)
+      {
+        for (size_t i = 0; i < nbKeys; ++i)
+        {
+          if (s_alignments[i] == alignment)
+          {
+            offsets[i] = offset;
+            offset += s_sizes[i];
+          }
+        }
+      }
+      // total size of the values
+      offsets[nbKeys] = offset;
+      return offsets;
+    }
+
+    constexpr static std::array<size_t,nbKeys + 1> s_offsets = getOffsets();
+
+    alignas(s_maxAlignment) unsigned char m_values[s_offsets[nbKeys]];
+
+    MaskType m_mask;
+
+    /// returns the position of TKey in TKeys, or nbKeys if it is not part of the set
+    template <class TKey>
+    constexpr inline static size_t getIndex()
+    {
+      return getKeyIndex<TKey, TKeys...>();
+    }
+
+    template <size_t Idx>
+    ValueType<KeyType<Idx>>* getPointer()
+    {
+      return std::launder(reinterpret_cast<ValueType<KeyType<Idx>>*>(m_values + s_offsets[Idx]));
+    }
+
+    template <size_t Idx>
+    const ValueType<KeyType<Idx>>* getPointer() const
+    {
+      return std::launder(
+        reinterpret_cast<const ValueType<KeyType<Idx>>*>(m_values + s_offsets[Idx]));
+    }
+
+    template <size_t Idx>
+    bool hasAt() const
+    {
+      return (m_mask >> Idx) & 1;
+    }
+
+    template <size_t Idx, class D>
+    void setAt(D&& _value)
+    {
+      if (hasAt<Idx>())
+      {
+        *getPointer<Idx>() = std::forward<D>(_value);
+      }
+      else
+      {
+        new (m_values + s_offsets[Idx]) ValueType<KeyType<Idx>>(std::forward<D>(_value));
+        m_mask |= MaskType(MaskType(1) << Idx);
+      }
+    }
+
+    template <size_t Idx>
+    void resetAt()
+    {
+      if (hasAt<Idx>())
+      {
+        typedef ValueType<KeyType<Idx>> V;
+        getPointer<Idx>()->~V();
+        m_mask &= MaskType(~(MaskType(1) << Idx));
+      }
+    }
+
+    template <size_t Idx>
+    std::optional<ValueType<KeyType<Idx>>> getAt() const
+    {
+      if (hasAt<Idx>())
+      {
+        return *getPointer<Idx>();
+      }
+      return std::nullopt;
+    }
+
+    /// sets the value of a named parameter, if the assigned optional is present
+    template <class T>
+    void assign(T&& _assignedKey)
+    {
+      typedef typename AssignedKeyType<typename std::decay<T>::type>::type TKey;
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+
+      auto& value = *_assignedKey.getValue();
+      if (value)
+      {
+        setAt<getIndex<TKey>()>(*value);
+      }
+    }
+
+    template <size_t... Is>
+    void copyFrom(const OptionSet& _other, std::index_sequence<Is...> const &)
+    {
+      ((_other.template hasAt<Is>() ? setAt<Is>(*_other.template getPointer<Is>()) 
+        : resetAt<Is>()), ...);
+    }
+
+    template <size_t... Is>
+    void moveFrom(OptionSet& _other, std::index_sequence<Is...> const &)
+    {
+      ((_other.template hasAt<Is>() ? setAt<Is>(std::move(*_other.template getPointer<Is>())) 
+        : resetAt<Is>()), ...);
+    }
+
+    template <size_t... Is>
+    void resetAll(std::index_sequence<Is...> const &)
+    {
+      (resetAt<Is>(), ...);
+    }
+
+    template <uint64_t TSkipped, size_t... Is>
+    static auto getSelection(std::index_sequence<Is...> const &) -> typename SelectedIndices<
+      nbKeys, (((TSkipped >> Is) & 1) ? nbKeys : Is)...>::Sequence;
+
+    /// positions of the keys which are not in TSkipped
+    template <uint64_t TSkipped>
+    using Selection = decltype(getSelection<TSkipped>(std::make_index_sequence<nbKeys>{}));
+
+    template <class TFunction, size_t... Is>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) expandIndices(TFunction& _function, 
+      std::index_sequence<Is...> const &) const
+    {
+      return _function((KeyType<Is>() = getAt<Is>())...);
+    }
+
+    template <size_t... Is>
+    static auto getExpandedArguments(std::index_sequence<Is...> const &)
+      -> std::tuple<decltype(
+        KeyType<Is>() = std::declval<const OptionSet&>().template getAt<Is>())...>;
+
+  public:
+
+    OptionSet()
+      : m_mask(0)
+    {
+    }
+
+    /// set with the present values of the named parameters _args
+    template <class... Any, std::enable_if_t<(sizeof...(Any) > 0) 
+      && std::conjunction<IsAssignedKey<typename std::decay<Any>::type>...>::value, int> = 0>
+    explicit OptionSet(Any&&... _args)
+      : m_mask(0)
+    {
+      (assign(std::forward<Any>(_args)), ...);
+    }
+
+    OptionSet(const OptionSet& _other)
+      : m_mask(0)
+    {
+      copyFrom(_other, std::make_index_sequence<nbKeys>{});
+    }
+
+    OptionSet(OptionSet&& _other)
+      : m_mask(0)
+    {
+      moveFrom(_other, std::make_index_sequence<nbKeys>{});
+    }
+
+    OptionSet& operator=(const OptionSet& _other)
+    {
+      if (this != &_other)
+      {
+        copyFrom(_other, std::make_index_sequence<nbKeys>{});
+      }
+      return *this;
+    }
+
+    OptionSet& operator=(OptionSet&& _other)
+    {
+      if (this != &_other)
+      {
+        moveFrom(_other, std::make_index_sequence<nbKeys>{});
+      }
+      return *this;
+    }
+
+    ~OptionSet()
+    {
+      reset();
+    }
+
+    /// bit i is set if the i-th key has a value
+    MaskType getMask() const
+    {
+      return m_mask;
+    }
+
+    template <class TKey>
+    bool has([[maybe_unused]] const TKey& _key) const
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      return hasAt<getIndex<TKey>()>();
+    }
+
+    /// returns a copy of the value of _key, std::nullopt if it has none
+    template <class TKey>
+    std::optional<ValueType<TKey>> get([[maybe_unused]] const TKey& _key) const
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      return getAt<getIndex<TKey>()>();
+    }
+
+    /// returns the value of _key, which has to be present
+    template <class TKey>
+    const ValueType<TKey>& value([[maybe_unused]] const TKey& _key) const
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      return *getPointer<getIndex<TKey>()>();
+    }
+
+    template <class TKey>
+    ValueType<TKey>& value([[maybe_unused]] const TKey& _key)
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      return *getPointer<getIndex<TKey>()>();
+    }
+
+    template <class TKey, class D>
+    ValueType<TKey> valueOr([[maybe_unused]] const TKey& _key, D&& _default) const
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      if (hasAt<getIndex<TKey>()>())
+      {
+        return *getPointer<getIndex<TKey>()>();
+      }
+      return static_cast<ValueType<TKey>>(std::forward<D>(_default));
+    }
+
+    template <class TKey, class D>
+    void set([[maybe_unused]] const TKey& _key, D&& _value)
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      setAt<getIndex<TKey>()>(std::forward<D>(_value));
+    }
+
+    /// removes the value of _key
+    template <class TKey>
+    void reset([[maybe_unused]] const TKey& _key)
+    {
+      static_assert(getIndex<TKey>() < nbKeys, "Key is not part of the OptionSet!");
+      resetAt<getIndex<TKey>()>();
+    }
+
+    /// removes all values
+    void reset()
+    {
+      resetAll(std::make_index_sequence<nbKeys>{});
+    }
+
+    /// calls _function with a named parameter for each key which is not in the bitmask 
+    /// TSkipped. Absent values are passed as std::nullopt
+    template <uint64_t TSkipped = 0, class TFunction>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) expand(TFunction&& _function) const
+    {
+      return expandIndices(_function, Selection<TSkipped>{});
+    }
+
+    /// types of the named parameters which expand<TSkipped> passes, as a std::tuple
+    template <uint64_t TSkipped>
+    using ExpandedArguments = decltype(
+      getExpandedArguments(Selection<TSkipped>{}));
+
+    /// key IDs in the order of TKeys
+    constexpr static std::array<int64_t,nbKeys> getKeyIDs()
+    {
+      return { TKeys::ID... };
+    }
+};
+
+
+/// FunctionTraits taken and adapted from "https://functionalcpp.wordpress.com/2013/08/05/function-traits/"
+/// A helper class to get the variable types of a function
+template <typename T>
+struct FunctionTraitsBase;
+
+template <typename T> 
+struct FunctionTraits;  
+
+template<typename R, typename ...Args> 
+struct FunctionTraitsBase<R(Args...)>
+{
+    static const size_t nbArgs = sizeof...(Args);
+
+    typedef R ResultType;
+
+    template <size_t i>
+    struct arg
+    {
+        typedef typename std::tuple_element<i, std::tuple<Args...>>::type type;
+    };
+};
+
+template <class R, typename ...Args>
+struct FunctionTraits<R(Args...)> : public FunctionTraitsBase<R(Args...)> 
+{
+  typedef void ClassType;
+};
+
+template <class C, class R, typename... Args>
+struct FunctionTraits<R(C::*)(Args...)> : public FunctionTraitsBase<R(Args...)>
+{
+  typedef C ClassType;
+};
+
+template <class C, class R, typename... Args>
+struct FunctionTraits<R(C::*)(Args...)const> : public FunctionTraitsBase<R(Args...)>
+{
+  typedef C ClassType;
+};
+
+/// wraps a (member) function pointer which is known at compile time. A KeyFunction of a 
+/// FunctionConstant calls the function directly instead of through a stored pointer
+template <auto TFunction>
+struct FunctionConstant
+{
+  constexpr static decltype(TFunction) value = TFunction;
+};
+
+template <auto TFunction>
+struct FunctionTraits<FunctionConstant<TFunction>> 
+  : public FunctionTraits<typename std::remove_pointer<decltype(TFunction)>::type>
+{
+};
+
+/// resolves TFunctionPtr to the underlying (member) function pointer type
+template <class TFunctionPtr>
+struct FunctionPointerType
+{
+  typedef TFunctionPtr type;
+
+  NAMEDPARAMS_FORCE_INLINE constexpr static type get(TFunctionPtr _function)
+  {
+    return _function;
+  }
+};
+
+template <auto TFunction>
+struct FunctionPointerType<FunctionConstant<TFunction>>
+{
+  typedef decltype(TFunction) type;
+
+  NAMEDPARAMS_FORCE_INLINE constexpr static type get(FunctionConstant<TFunction>)
+  {
+    return TFunction;
+  }
+};
+
+/// true if R is the return type of a coroutine, i.e. has a promise_type
+template <class R, class = void>
+struct IsCoroutineType : public std::false_type {};
+
+template <class R>
+struct IsCoroutineType<R, std::void_t<typename R::promise_type>> : public std::true_type {};
+
+template <class T, bool B>
+struct _RemoveConstIfNotReferenceImpl;
+
+template <class T>
+struct _RemoveConstIfNotReferenceImpl<T,false>
+{
+  typedef T type;
+};
+
+template <class T>
+struct _RemoveConstIfNotReferenceImpl<T,true>
+{
+  typedef typename std::remove_const<T>::type type;
+};
+
+template <class T>
+struct RemoveConstIfNotReference
+{
+  typedef typename _RemoveConstIfNotReferenceImpl<T,!std::is_reference<T>::value>::type type;
+};
+
+/// returns true if argument types to function are all the same as the tyes contained in the keys
+template <class TFunctionPtr, class... TFunctionKeys, size_t... Is>
+constexpr inline int KeyTypesAreValid(std::index_sequence<Is...> const &)
+{
+  // passing const by value to a function has no effect, and so decays to non-const
+  // in function pointer. We therefore also remove const here
+  using KeyTuple = std::tuple<typename RemoveConstIfNotReference<
+    typename TFunctionKeys::type>::type...>;
+  using TFunctionTraits = FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type>;
+
+  constexpr std::array<bool,sizeof...(TFunctionKeys)> keyTypesCompare = {
+    std::is_same<
+      typename std::tuple_element<Is, KeyTuple>::type, 
+      typename TFunctionTraits::template arg<Is>::type
+    >::value...};
+
+  for (int i = 0; i < (int)sizeof...(TFunctionKeys); ++i)
+  {
+    if (!keyTypesCompare[i])
+    {
+      return i;
+    }
+  }
+
+  return -1;
+
+}
+
+/// returns the position of the first key with the same ID, else -1
+template <class... TFunctionKeys>
+constexpr inline int MultipleIdenticalKeys()
+{
+  std::array<int64_t, sizeof...(TFunctionKeys)> keyIDs = { TFunctionKeys::ID... };
+  _sort(keyIDs.begin(), keyIDs.end());
+  for (int i = 1; i < (int)sizeof...(TFunctionKeys); ++i) 
+  {
+    if (keyIDs[i-1] == keyIDs[i])
+    {
+      return i-1;
+    }
+  }
+  return -1;
+} 
+
+/// groups all functions from above to check if keys are valid for the given function
+template <class TFunctionPtr, class... TFunctionKeys>
+constexpr inline bool KeyFunctionTemplateIsValid() 
+{
+  // Check if TFunctionPtr is really a (member) function pointer
+  // This is necessary because templates are checked for both constructors
+  // in KeyFunction, even if only one is enabled. This leads to errors 
+  // in this function. 
+  typedef typename FunctionPointerType<TFunctionPtr>::type FunctionPtr;
+  if constexpr (std::is_function<typename std::remove_pointer<FunctionPtr>::type>::value
+    || std::is_member_function_pointer<FunctionPtr>::value)
+  {
+    constexpr int nbFunctionArgs = FunctionTraits< 
+      typename std::remove_pointer<FunctionPtr>::type>::nbArgs;
+
+    constexpr int nbKeys = sizeof...(TFunctionKeys);
+    if constexpr (nbFunctionArgs != nbKeys)
+    {
+      failWithMessage<
+        ErrorType::INCORRECT_NUMBER_OF_KEYS_PASSED_TO_KEYFUNCTION,
+        nbFunctionArgs,nbKeys>();
+      return false;
+    }
+
+    constexpr int invalidKey = KeyTypesAreValid<FunctionPtr,TFunctionKeys...>(
+      std::make_index_sequence<nbFunctionArgs>());
+    if constexpr (invalidKey >= 0)
+    {
+      failWithMessage<
+        ErrorType::KEY_HAS_WRONG_TYPE,
+        std::tuple_element<invalidKey, std::tuple<TFunctionKeys...>>::type::name>();
+      return false;
+    }
+
+    constexpr int duplicateKey = MultipleIdenticalKeys<TFunctionKeys...>();
+    if constexpr (duplicateKey >= 0)
+    {
+      failWithMessage<ErrorType::SAME_KEY_PASSED_MORE_THAN_ONCE_KEYFUNCTION, duplicateKey>();
+      return false;
+    }
+
+    // TODO: ENFORCE OPTIONAL KEYS AFTER NON-OPTIONAL KEYS (?)
+    return true;
+  }
+
+  return false;
+
+}
+
+/// tag which makes KeyFunction::internal3 call the wrapped function through its shared thunk
+struct CanonicalCall {};
+
+/// Specialized by NAMEDPARAMS_DECLARE_CALL for call signatures of TKeyFunction which are 
+/// explicitly instantiated in one translation unit with NAMEDPARAMS_INSTANTIATE_CALL.
+/// Calls with these signatures are not validated again, and call the instantiated function.
+/// Signatures are matched after DeclaredArgument
+template <class TKeyFunction, class... Any>
+struct DeclaredCall : public std::false_type {};
+
+/// type of a passed argument T in a declared signature: AssignedKey<TKey> for all assigned keys 
+/// of TKey, whatever their value category and their temporary and constant markers
+template <class T, bool = IsAssignedKey<typename std::decay<T>::type>::value>
+struct DeclaredArgument
+{
+  typedef T type;
+};
+
+template <class T>
+struct DeclaredArgument<T,true>
+{
+  typedef AssignedKey<typename AssignedKeyType<typename std::decay<T>::type>::type> type;
+};
+
+/// KeyFunction is a class which wraps around a (member) function pointer
+/// operator()() lets you call the function using positiionals, named parameters and optionals
+template <class TFunctionPtr, class... TFunctionKeys>
+class KeyFunction
+{
+  private:
+
+    typedef FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type> KeyFunctionTraits;
+
+    typename KeyFunctionTraits::ClassType* m_classPtr;
+
+    TFunctionPtr m_baseFunction; 
+
+    constexpr inline static std::array<int64_t, KeyFunctionTraits::nbArgs> m_functionKeyIDs = { 
+      TFunctionKeys::ID... };
+
+  public:
+
+    /// constructor for non-member, or static member functions
+    template <class DFunctionPtr, class... DFunctionKeys,
+      std::enable_if_t<
+        !std::is_member_function_pointer<
+          typename FunctionPointerType<DFunctionPtr>::type>::value
+        && KeyFunctionTemplateIsValid<DFunctionPtr,DFunctionKeys...>()
+      , bool> = true>
+    constexpr KeyFunction(DFunctionPtr _function, [[maybe_unused]] const DFunctionKeys&... _keys)
+      : m_classPtr(nullptr)
+      , m_baseFunction(_function)
+    {
+    }
+
+    /// constructor for non-static member functions which additionally accepts a pointer to 
+    /// an instance of its class
+    template <class DFunctionPtr, class... DFunctionKeys, 
+      std::enable_if_t<
+        std::is_member_function_pointer<
+          typename FunctionPointerType<DFunctionPtr>::type>::value
+        && KeyFunctionTemplateIsValid<DFunctionPtr,DFunctionKeys...>()
+      , bool> = true>
+    constexpr KeyFunction(typename KeyFunctionTraits::ClassType* _classPtr, 
+      DFunctionPtr _function, [[maybe_unused]] const DFunctionKeys&... _keys)
+      : m_classPtr(_classPtr)
+      , m_baseFunction(_function)
+    {
+    }
+
+    typedef typename KeyFunctionTraits::ResultType ResultType;
+
+    typename FunctionPointerType<TFunctionPtr>::type getBaseFunction() const
+    {
+      return FunctionPointerType<TFunctionPtr>::get(m_baseFunction);
+    }
+
+    /// struct used in constexpr functions which encapsulates some info about the error
+    struct EvalReturn
+    {
+      ErrorType errorType;
+      int id;
+      int isFuncID; // wether id refers to TFunctionKeys (0), Any (pos) or None (neg)
+    };
+
+    /// reserved negative key IDs to complement the positive "real" key IDs
+    enum KeyIdType 
+    {
+      POSITIONAL = -1,
+      UNKNOWN = -2,
+      ABSENT = -3
+    };
+
+    // get local key IDs for passed arguments
+    // unknown arguments are given ID = -2
+    // positional arguments are given ID = -1
+    // named arguments are assigned its position in the function argument list
+    template <class... Any>
+    constexpr inline static std::array<int64_t,sizeof...(Any)> getLocalKeyIDs()
+    {
+      constexpr int nbPassedArgs = sizeof...(Any);
+      std::array<int64_t, nbPassedArgs> passedKeyIDs = { GetArgumentID<Any>::ID... };
+      std::array<int64_t, nbPassedArgs> passedLocalKeyIDs = {};
+      
+      for (int i = 0; i < nbPassedArgs; ++i) 
+      {
+        if (passedKeyIDs[i] < 0)
+        {
+          passedLocalKeyIDs[i] = KeyIdType::POSITIONAL;
+          continue;
+        }
+
+        auto iter = _find(m_functionKeyIDs.begin(), m_functionKeyIDs.end(), passedKeyIDs[i]);
+
+        if (iter == m_functionKeyIDs.end())
+        {
+          passedLocalKeyIDs[i] = KeyIdType::UNKNOWN;
+        }
+        else 
+        {
+          int64_t idx = iter - m_functionKeyIDs.begin();
+          passedLocalKeyIDs[i] = idx;
+        }
+
+      }
+
+      return passedLocalKeyIDs;
+    }
+
+    /// sort the passed arguments according to order of functionKeys
+    /// do it here in this function, so we do not need to do it at runtime
+    /// returns a sorted array where array[idx] gives the original position of 
+    /// the passed argument
+    template <class... Any>
+    constexpr inline static std::array<int64_t,sizeof...(Any)> getSortedIndices(
+      const std::array<int64_t,sizeof...(Any)>& localKeyIDs)
+    {
+      constexpr int nbPassedKeys = sizeof...(Any);
+      std::array<int64_t, nbPassedKeys> indices = {};
+      for (int i = 0; i < nbPassedKeys; ++i)
+      {
+        indices[i] = i;
+      }
+
+      _sort(indices.begin(), indices.end(), 
+        [&](const int64_t a, const int64_t b)
+        {
+          return localKeyIDs[a] < localKeyIDs[b];
+        });
+
+      return indices;
+
+    }
+
+    /// returns a pair containing the number of positionals and named arguments
+    template <class... Any>
+    constexpr inline static std::pair<int,int> getNb() 
+    {
+      std::array<bool,sizeof...(Any)> types = 
+      {
+        IsAssignedKey<Any>::value...
+      };
+
+      std::pair<int,int> group = std::make_pair(0,0);
+      for (auto t : types)
+      {
+        if (!t)
+        {
+          group.first++;
+        }
+        else 
+        {
+          group.second++;
+        }
+      }
+
+      return group;
+
+    }
+
+    /// struct to get the ID of a passed argument
+    /// if D is a non-Key, it is a positional
+    template <class D>
+    struct GetArgumentID 
+    {
+      const inline static int64_t ID = KeyIdType::POSITIONAL;
+    };
+
+    template <class D, bool B, class C>
+    struct GetArgumentID<AssignedKey<D,B,C>>
+    {
+      const inline static int64_t ID = D::ID;
+    };
+
+    /// checks if the positional type can be converted to the type needed by the function
+    template <class... Any, size_t... Is>
+    constexpr inline static std::array<bool,sizeof...(Is)> 
+    positionalConversion(std::index_sequence<Is...> const &) 
+    {
+      constexpr std::array<bool,sizeof...(Is)> out = 
+      { 
+        std::is_convertible<
+          typename std::tuple_element<Is, std::tuple<Any...>>::type, 
+          typename KeyFunctionTraits::template arg<Is>::type
+        >::value...
+      };
+
+      // TODO: BETTER ERROR HANDLING: SHOW WHICH TYPES CANNOT BE CONVERTED
+
+      return out;
+    }
+    
+    /// true if the passed argument TArg creates a temporary for a reference parameter.
+    /// LocalID is the position of the parameter, or UNKNOWN
+    template <class TArg, int64_t LocalID>
+    constexpr inline static bool isTemporaryReference()
+    {
+      if constexpr (LocalID < 0)
+      {
+        return false;
+      }
+      else if constexpr (IsAssignedKey<TArg>::value)
+      {
+        return std::remove_reference<TArg>::type::isTemporary;
+      }
+      else 
+      {
+        typedef typename KeyFunctionTraits::template arg<LocalID>::type ArgType;
+        return std::is_reference<ArgType>::value && (!std::is_lvalue_reference<TArg>::value
+          || !std::is_convertible<typename std::remove_reference<TArg>::type*,
+            typename std::remove_reference<ArgType>::type*>::value);
+      }
+    }
+
+    /// returns the position of the first passed argument which is a temporary bound to a 
+    /// reference parameter, else -1
+    template <class... Any, size_t... Is>
+    constexpr inline static int findTemporaryReference(std::index_sequence<Is...> const &)
+    {
+      constexpr std::array<int64_t,sizeof...(Any)> localKeyIDs = getLocalKeyIDs<Any...>();
+      constexpr std::array<bool,sizeof...(Any)> isTemporary = 
+      {
+        isTemporaryReference<Any,(localKeyIDs[Is] == KeyIdType::POSITIONAL) 
+          ? static_cast<int64_t>(Is) : localKeyIDs[Is]>()...
+      };
+
+      for (int i = 0; i < (int)sizeof...(Any); ++i)
+      {
+        if (isTemporary[i])
+        {
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    /// this function is used to evaluate the template parameters for operator()
+    /// that is: correct order, correct type, missing keys, invalid keys, duplicate keys...
+    /// returns an error containing some info depending on the context
+    template <class... Any>
+    constexpr inline static EvalReturn evalAny()
+    {
+
+      // get number of different arguments
+      constexpr auto group = getNb<Any...>();
+      constexpr int nbPositionalArgs = group.first;
+      constexpr int nbAssignedKeys = group.second;
+      constexpr int nbFunctionKeys = sizeof...(TFunctionKeys);
+      constexpr int nbPassedArgs = sizeof...(Any);
+
+      // check if positional arguments are grouped together
+      constexpr std::array<bool,sizeof...(Any)> isKey = 
+      {
+        IsAssignedKey<Any>::value...
+      };
+
+      for (int i = 1; i < nbPassedArgs; ++i)
+      {
+        // key should not follow positional argument
+        if (isKey[i-1] && !isKey[i])
+        {
+          return EvalReturn{ErrorType::POSITIONAL_CANNOT_FOLLOW_KEY_ARGUMENT, i, 0};
+        }
+      }
+      
+      // check if positional arguments are correct types or convertible (Keys are set to always true)
+      std::array<bool,nbPositionalArgs> positionalIsConvertible = positionalConversion<Any...>(
+        std::make_index_sequence<nbPositionalArgs>());
+
+      for (int i = 0; i < nbPositionalArgs; ++i)
+      {
+        if (!positionalIsConvertible[i])
+        {
+          return EvalReturn{ErrorType::COULD_NOT_CONVERT_KEY_TYPE_TO_ARGUMENT_TYPE, i, 0};
+        }
+      }
+      
+      // a coroutine keeps its reference parameters beyond the call, so they cannot be bound
+      // to temporaries. By-value parameters are moved into the coroutine frame
+      if constexpr (IsCoroutineType<typename KeyFunctionTraits::ResultType>::value)
+      {
+        constexpr int temporary = findTemporaryReference<Any...>(
+          std::make_index_sequence<nbPassedArgs>());
+        if (temporary >= 0)
+        {
+          return EvalReturn{ErrorType::TEMPORARY_BOUND_TO_COROUTINE_REFERENCE, temporary, 
+            isKey[temporary] ? 1 : -1};
+        }
+      }
+
+      // check if keys are all correct types <----
+      // maybe in the constructor directly, probably better?
+    
+      // get relative/local key IDs
+      std::array<int64_t, nbFunctionKeys> functionLocalKeyIDs = {};
+      
+      for (int i = 0; i < nbFunctionKeys; ++i) 
+      {
+        functionLocalKeyIDs[i] = i;
+      }
+      
+      constexpr std::array<int64_t, nbPassedArgs> passedLocalKeyIDs = getLocalKeyIDs<Any...>();
+      
+      std::array<bool,nbFunctionKeys> functionKeyIsOptional = {
+        IsOptional<typename TFunctionKeys::type>::value...};
+
+      int nbRequiredKeys = 0;
+      for (auto fOpt : functionKeyIsOptional)
+      { 
+        nbRequiredKeys += (fOpt) ? 0 : 1;
+      }
+      
+      // if no args passed, but function has required keys, throw error 
+      // (e.g. funcWrapper() -> func(int))
+      if (nbRequiredKeys != 0 && nbPassedArgs == 0)
+      {
+        return EvalReturn{ErrorType::MISSING_KEY, 0, 0};
+      }
+
+      // if func only has optional arguments, and no args were passed we can return immediately
+      // e.g. funcWrapper() -> func(std::optional<int>)
+      if (nbRequiredKeys == 0 && nbPassedArgs == 0)
+      {
+        return EvalReturn{ErrorType::NONE, 0, 0};
+      }
+
+      // if all required keys in positional arguments, and no keys -> return
+      // e.g. funcWrapper(1,2,3) -> func(int, int, std::optional)
+      if (nbRequiredKeys <= nbPositionalArgs && nbAssignedKeys == 0)
+      {
+        return EvalReturn{ErrorType::NONE, 0, 0};
+      }
+
+      // check if unknown key present
+      for (int i = nbPositionalArgs; i < nbPassedArgs; ++i)
+      {
+        if (passedLocalKeyIDs[i] == KeyIdType::UNKNOWN) 
+        {
+          return EvalReturn{ErrorType::INVALID_KEY,i,1};
+        }
+      }
+
+      // now sort the Key IDs for checking correct keys 
+
+      constexpr auto sortIndex = getSortedIndices<Any...>(passedLocalKeyIDs);
+
+      std::array<int64_t,nbPassedArgs> passedSortedKeyIDs = {};
+
+      for (int i = 0; i < nbPassedArgs; ++i)
+      {
+        passedSortedKeyIDs[i] = passedLocalKeyIDs[sortIndex[i]];
+      }
+
+      //_sort(passedLocalKeyIDs.begin(), passedLocalKeyIDs.end());
+
+       // check for multiple keys of same type
+      for (int i = nbPositionalArgs+1; i < nbPassedArgs; ++i)
+      {
+        if (passedSortedKeyIDs[i-1] == passedSortedKeyIDs[i])
+        {
+          return EvalReturn{ErrorType::SAME_KEY_PASSED_MORE_THAN_ONCE, static_cast<int>(sortIndex[i-1]), 1};
+        }
+      }
+
+      int offset = 0;
+      
+      for (int iArg = nbPositionalArgs; iArg < nbFunctionKeys; ++iArg)
+      {
+        // no more passed keys to parse, and function key is NOT optional
+        if (iArg >= nbPassedArgs+offset && !functionKeyIsOptional[iArg])
+        {
+          return EvalReturn{ErrorType::MISSING_KEY, iArg, 0};
+        }
+        // no more passed keys to parse and function key IS optional 
+        else if (iArg >= nbPassedArgs+offset && functionKeyIsOptional[iArg])
+        {
+          continue;
+        }
+        // function key should never be larger than the pass key
+        else if (functionLocalKeyIDs[iArg] > passedSortedKeyIDs[iArg-offset])
+        {
+          return EvalReturn{ErrorType::INVALID_KEY, static_cast<int>(sortIndex[iArg-offset]), 1};
+        }
+        // if the function key is smaller, some key might be missing - check if optional
+        else if (functionLocalKeyIDs[iArg] < passedSortedKeyIDs[iArg-offset] 
+                 && !functionKeyIsOptional[iArg])
+        {
+          return EvalReturn{ErrorType::MISSING_KEY, iArg, 0};
+        }
+        // same as above. but incrementing offset
+        else if (functionLocalKeyIDs[iArg] < passedSortedKeyIDs[iArg-offset] 
+        && functionKeyIsOptional[iArg])
+        {
+          offset++;
+        }
+      }
+
+      return EvalReturn{ErrorType::NONE, 0, 0};
+    
+    }
+    
+    /// Encapsulates evalAny() and handes the error
+    /// returns true if class... Any is compatible with the function
+    template <class... Any>
+    constexpr inline static bool evalAnyError()
+    {
+      // check for too many args to avoid further error messages and clogging up compiler output
+      if constexpr (sizeof...(Any) > sizeof...(TFunctionKeys))
+      {
+        failWithMessage<ErrorType::TOO_MANY_ARGUMENTS_PASSED_TO_FUNCTION, sizeof...(Any),
+          sizeof...(TFunctionKeys)>();
+        return false;
+      } 
+      else 
+      {
+
+        constexpr EvalReturn error = evalAny<Any...>();
+      
+        if constexpr (error.errorType != ErrorType::NONE)
+        {
+          constexpr size_t idx = static_cast<size_t>(error.id);
+      
+          if constexpr ( error.isFuncID == 0 )
+          {
+            using KeyType = typename std::tuple_element<idx, std::tuple<TFunctionKeys...> >::type;
+            constexpr auto keyName = KeyType::name;
+            failWithMessage<error.errorType, keyName>();
+          }
+          else if constexpr ( error.isFuncID > 0) 
+          {
+            using KeyType = typename std::tuple_element<idx, std::tuple<Any...> >::type::keyType;
+            constexpr auto keyName = KeyType::name;
+            failWithMessage<error.errorType, keyName>();
+          }
+          else 
+          {
+            failWithMessage<error.errorType, error.id>();
+          }
+          return false;
+        }
+      }      
+
+      return true;
+    }
+    
+    /// the check of evalAnyError without its error messages, for constraints which have to fail 
+    /// quietly, e.g. of converting constructors
+    template <class... Any>
+    constexpr inline static bool isValidArgumentList()
+    {
+      if constexpr (sizeof...(Any) > sizeof...(TFunctionKeys))
+      {
+        return false;
+      }
+      else 
+      {
+        return evalAny<Any...>().errorType == ErrorType::NONE;
+      }
+    }
+
+    /// evalAnyError as a type, so the evaluation can be skipped in std::disjunction
+    template <class... Any>
+    struct IsValidCall : public std::bool_constant<evalAnyError<Any...>()> {};
+
+    /// true if the call with Any matches a signature declared with NAMEDPARAMS_DECLARE_CALL.
+    /// DeclaredArgument drops the temporary marker, so a call to a coroutine which binds a 
+    /// temporary to a reference parameter is not matched, and fails in evalAnyError
+    template <class... Any>
+    constexpr inline static bool isDeclaredCall()
+    {
+      if constexpr (!DeclaredCall<KeyFunction,typename DeclaredArgument<Any>::type...>::value)
+      {
+        return false;
+      }
+      else if constexpr (IsCoroutineType<typename KeyFunctionTraits::ResultType>::value)
+      {
+        return findTemporaryReference<Any...>(std::make_index_sequence<sizeof...(Any)>()) < 0;
+      }
+      else 
+      {
+        return true;
+      }
+    }
+
+    template <class... Any>
+    struct IsDeclaredCall : public std::bool_constant<isDeclaredCall<Any...>()> {};
+
+    /// number of OptionSets passed to operator()
+    template <class... Any>
+    constexpr inline static size_t getNbOptionSets()
+    {
+      return (size_t(IsOptionSet<typename std::decay<Any>::type>::value) + ... + 0);
+    }
+
+    /// returns a bitmask of the keys of TOptionSet which are passed in Any, as named parameters
+    /// or as positionals
+    template <class TOptionSet, class... Any>
+    constexpr inline static uint64_t getOverriddenOptions()
+    {
+      constexpr std::array<int64_t,sizeof...(Any) + 1> passedKeyIDs = 
+      { 
+        GetArgumentID<typename std::decay<Any>::type>::ID..., KeyIdType::UNKNOWN 
+      };
+      constexpr std::array<int64_t,TOptionSet::nbKeys> optionKeyIDs = TOptionSet::getKeyIDs();
+
+      uint64_t mask = 0;
+      for (size_t i = 0; i < sizeof...(Any); ++i)
+      {
+        // positionals are passed for the function keys in order
+        const int64_t id = (passedKeyIDs[i] != KeyIdType::POSITIONAL) ? passedKeyIDs[i] 
+          : (i < sizeof...(TFunctionKeys)) ? m_functionKeyIDs[i] : int64_t(KeyIdType::UNKNOWN);
+
+        for (size_t j = 0; j < TOptionSet::nbKeys; ++j)
+        {
+          if (optionKeyIDs[j] == id)
+          {
+            mask |= uint64_t(1) << j;
+          }
+        }
+      }
+      return mask;
+    }
+
+    /// position of the OptionSet in Any
+    template <class... Any>
+    constexpr inline static size_t getOptionSetIndex()
+    {
+      constexpr std::array<bool,sizeof...(Any)> isOptionSet = 
+      {
+        IsOptionSet<typename std::decay<Any>::type>::value...
+      };
+      size_t idx = 0;
+      while (!isOptionSet[idx])
+      {
+        ++idx;
+      }
+      return idx;
+    }
+
+    /// arguments of a call with an OptionSet at OptionSetIdx after its expansion by 
+    /// callOptionSetImpl: the other arguments, followed by the named parameters of the keys of 
+    /// the set which are not passed explicitly
+    template <size_t OptionSetIdx, class TArguments, size_t... Is>
+    static auto getOptionSetCallArguments(std::index_sequence<Is...> const &)
+      -> decltype(std::tuple_cat(
+        std::declval<std::tuple<typename std::tuple_element<
+          (Is < OptionSetIdx) ? Is : Is + 1, TArguments>::type...>>(),
+        std::declval<typename std::decay<typename std::tuple_element<OptionSetIdx, 
+          TArguments>::type>::type::template ExpandedArguments<getOverriddenOptions<
+            typename std::decay<typename std::tuple_element<OptionSetIdx, TArguments>::type>::type,
+            typename std::tuple_element<(Is < OptionSetIdx) ? Is : Is + 1, TArguments>::type...
+          >()>>()));
+
+    /// IsValidCall for the arguments of a std::tuple
+    template <class TArguments>
+    struct IsValidCallOf;
+
+    template <class... Any>
+    struct IsValidCallOf<std::tuple<Any...>> : public IsValidCall<Any...> {};
+
+    /// evalAnyError of a call with an OptionSet, evaluated on its expanded arguments
+    template <class... Any>
+    constexpr inline static bool evalOptionSetCall()
+    {
+      static_assert(getNbOptionSets<Any...>() == 1, "Only one OptionSet can be passed to a call!");
+      if constexpr (getNbOptionSets<Any...>() == 1)
+      {
+        return IsValidCallOf<decltype(getOptionSetCallArguments<getOptionSetIndex<Any...>(), 
+          std::tuple<Any...>>(std::make_index_sequence<sizeof...(Any) - 1>{}))>::value;
+      }
+      else 
+      {
+        return false;
+      }
+    }
+
+    template <class... Any>
+    struct IsValidOptionSetCall : public std::bool_constant<evalOptionSetCall<Any...>()> {};
+
+    /// call to the internal function pointer using positionals and named parameters
+    /// fails at compile time if passed arguments are invalid
+    template <class... Any, std::enable_if_t<
+      std::conditional<(getNbOptionSets<Any...>() > 0), IsValidOptionSetCall<Any...>, 
+        std::disjunction<IsDeclaredCall<Any...>, IsValidCall<Any...>>>::type::value, int> = 0>
+    NAMEDPARAMS_FORCE_INLINE typename KeyFunctionTraits::ResultType operator()(Any&&... _args) const 
+    {
+      if constexpr (getNbOptionSets<Any...>() > 0)
+      {
+        return callOptionSet(_NAMEDPARAMS_FORWARD(Any, _args)...);
+      }
+      else
+      {
+#ifdef NAMEDPARAMS_ENABLE_INSTRUMENTATION
+        ScopedCallTimer<KeyFunction> timer(getPresenceMask<Any...>());
+#endif
+        if constexpr (isDeclaredCall<Any...>())
+        {
+          return callDeclared<typename DeclaredArgument<Any>::type...>(
+            toDeclaredArgument<Any>(_args)...);
+        }
+        else 
+        {
+          return callInline<Any...>(_NAMEDPARAMS_FORWARD(Any, _args)...);
+        }
+      }
+    }
+
+    /// passes the values of the OptionSet in _args as named parameters after the other 
+    /// arguments, except for keys which are passed explicitly
+    template <class... Any>
+    NAMEDPARAMS_FORCE_INLINE typename KeyFunctionTraits::ResultType callOptionSet(
+      Any&&... _args) const 
+    {
+      auto arguments = std::forward_as_tuple(_NAMEDPARAMS_FORWARD(Any, _args)...);
+      return callOptionSetImpl<getOptionSetIndex<Any...>()>(arguments, 
+        std::make_index_sequence<sizeof...(Any) - 1>{});
+    }
+
+    template <size_t OptionSetIdx, class TArguments, size_t... Is>
+    NAMEDPARAMS_FORCE_INLINE typename KeyFunctionTraits::ResultType callOptionSetImpl(
+      TArguments& _arguments, std::index_sequence<Is...> const &) const 
+    {
+      typedef typename std::decay<
+        typename std::tuple_element<OptionSetIdx,TArguments>::type>::type TOptionSet;
+      constexpr uint64_t overridden = getOverriddenOptions<TOptionSet, typename std::tuple_element<
+        (Is < OptionSetIdx) ? Is : Is + 1, TArguments>::type...>();
+
+      return std::get<OptionSetIdx>(_arguments).template expand<overridden>(
+        [&](auto&&... _options) -> typename KeyFunctionTraits::ResultType
+        {
+          return (*this)(std::get<(Is < OptionSetIdx) ? Is : Is + 1>(std::move(_arguments))..., 
+            _NAMEDPARAMS_FORWARD(decltype(_options), _options)...);
         });
+    }
 
-      return indices;
+    /// passes argument _arg of type T as its DeclaredArgument
+    template <class T>
+    NAMEDPARAMS_FORCE_INLINE static decltype(auto) toDeclaredArgument(T& _arg)
+    {
+      typedef typename DeclaredArgument<T>::type D;
+      if constexpr (std::is_same<D,T>::value)
+      {
+        return _NAMEDPARAMS_FORWARD(T, _arg);
+      }
+      else 
+      {
+        return D(static_cast<typename std::decay<T>::type&&>(_arg));
+      }
+    }
+
+    /// out-of-line call for signatures declared with NAMEDPARAMS_DECLARE_CALL. 
+    /// It is not inline, so translation units only see the extern template declaration
+    template <class... Any>
+    typename KeyFunctionTraits::ResultType callDeclared(Any&&... _args) const;
+
+    /// reorders the arguments and calls the internal function pointer
+    template <class... Any>
+    NAMEDPARAMS_FORCE_INLINE typename KeyFunctionTraits::ResultType callInline(Any&&... _args) const 
+    {
+      return internal3<Any...>(CanonicalCall{}, _NAMEDPARAMS_FORWARD(Any, _args)..., 
+        std::make_index_sequence<sizeof...(TFunctionKeys)>{});
+    }
+
+    /// reorders positionals and named parameters like operator(), but passes them to _invoker
+    /// instead of the internal function pointer. Absent optionals are passed as std::nullopt.
+    /// fails at compile time if passed arguments are invalid
+    template <class TInvoker, class... Any, std::enable_if_t<evalAnyError<Any...>(), int> = 0>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) apply(TInvoker&& _invoker, Any&&... _args) const 
+    {
+      return internal3<Any...>(_NAMEDPARAMS_FORWARD(TInvoker, _invoker), 
+        _NAMEDPARAMS_FORWARD(Any, _args)..., 
+        std::make_index_sequence<sizeof...(TFunctionKeys)>{});
+    }
+
+    /// return internal address in assigned key
+    template <typename T, std::enable_if_t<IsAssignedKey<T>::value,bool> = true>
+    NAMEDPARAMS_FORCE_INLINE static void* getAddress(T& _assignedKey)
+    {
+      return (void*)_assignedKey.getValue();
+    }
+
+    /// return address of passed value
+    template <typename T, std::enable_if_t<!IsAssignedKey<T>::value,int> = 0>
+    NAMEDPARAMS_FORCE_INLINE static void* getAddress(T& _value)
+    {
+      return (void*)&_value;
+    }
+
+    /// returns the address of the argument passed for function argument Idx
+    template <size_t Idx, int64_t ArgIdx>
+    NAMEDPARAMS_FORCE_INLINE static void* getPaddedAddress([[maybe_unused]] 
+      void* const* _addresses)
+    {
+      if constexpr (ArgIdx == KeyIdType::ABSENT)
+      {
+        return nullptr;
+      }
+      else if constexpr (ArgIdx == KeyIdType::POSITIONAL)
+      {
+        return _addresses[Idx];
+      }
+      else 
+      {
+        return _addresses[ArgIdx];
+      }
+    }
+
+    /// utility struct to get the type of positional nr. Idx in TPositionals
+    /// if the argument is not a positional, the type defaults to void
+    template <size_t Idx, class TPositionals, bool IsPositional = (Idx < std::tuple_size<TPositionals>::value)>
+    struct PositionalType
+    {
+      using type = typename std::tuple_element<Idx,TPositionals>::type;
+    };
+
+    template <size_t Idx, class TPositionals>
+    struct PositionalType<Idx,TPositionals,false>
+    {
+      using type = void;
+    };
+
+    /// tuple type of the positionals in Any, the first nbPositionals types
+    template <class... Any, size_t... Ps>
+    static auto getPositionalTuple(std::index_sequence<Ps...> const &) 
+      -> std::tuple<typename std::tuple_element<Ps, std::tuple<Any...>>::type...>;
+
+    template <class... Any>
+    using PositionalTuple = decltype(getPositionalTuple<Any...>(
+      std::make_index_sequence<getNb<Any...>().first>{}));
+
+    /// reads function argument Idx from the address filled in by internal3
+    /// absent optionals are returned as nullopt, named arguments are moved out of their key.
+    /// Positionals of type TPositional are converted or copied if the function argument does not
+    /// bind to them directly, the same way as in a direct call
+    template <size_t Idx, bool Present, class TPositional>
+    NAMEDPARAMS_FORCE_INLINE static decltype(auto) getCanonicalArgument([[maybe_unused]] void* _address)
+    {
+      typedef typename KeyFunctionTraits::template arg<Idx>::type ArgType;
+      typedef typename std::remove_reference<ArgType>::type NoRefType;
+
+      if constexpr (!Present)
+      {
+        return std::nullopt_t(std::nullopt);
+      }
+      else if constexpr (std::is_void<TPositional>::value)
+      {
+        return _NAMEDPARAMS_FORWARD(ArgType, *static_cast<NoRefType*>(_address));
+      }
+      else 
+      {
+        typedef typename std::remove_reference<TPositional>::type NoRefPositional;
+        NoRefPositional& value = *static_cast<NoRefPositional*>(_address);
+
+        if constexpr (std::is_reference<ArgType>::value 
+          && std::is_convertible<NoRefPositional*,NoRefType*>::value)
+        {
+          return static_cast<ArgType>(_NAMEDPARAMS_FORWARD(TPositional, value));
+        }
+        else 
+        {
+          return typename std::remove_cv<NoRefType>::type(_NAMEDPARAMS_FORWARD(TPositional, value));
+        }
+      }
+    }
+
+    /// calls the function with the reordered arguments. Its instantiation only depends on the 
+    /// positional types and which keys are present, so all permutations of the same keys share it
+    template <class TPositionals, bool... Present, size_t... Is>
+    typename KeyFunctionTraits::ResultType callCanonical(void* const* _addresses, 
+      std::integer_sequence<bool,Present...> const &, std::index_sequence<Is...> const &) const
+    {
+      return call(getCanonicalArgument<Is,Present,
+        typename PositionalType<Is,TPositionals>::type>(_addresses[Is])...);
+    }
+
+    /// computes the position of each function key in the list of passed arguments
+    /// paddedList[i] will return the position of key with id=i in the argument list
+    /// if entry is -1, it is a positional
+    /// if entry is -3, it is not present in the argument list
+    template <class... Any>
+    constexpr inline static std::array<int64_t,sizeof...(TFunctionKeys)> getPaddedList()
+    {
+      constexpr auto group = getNb<Any...>();
+      constexpr int nbPositionals = group.first;
+      constexpr int nbPassedArgs = sizeof...(Any);
+      constexpr int nbFunctionKeys = sizeof...(TFunctionKeys);
+
+      // potentially unordered local key
+      // "local" meaning relative to function keys
+      // e.g. for keys passed to KeyFunction (1515, 845, 1233) 
+      //      keys passed to function (845, 1515) become (1,0)
+      constexpr std::array<int64_t,nbPassedArgs> passedLocalKeys = getLocalKeyIDs<Any...>();
+
+      // get indices which will sort the local keys
+      // indices[i] will give you the position in the arg list of key with id=i 
+      // (positionals still have id=-1)
+      constexpr std::array<int64_t,nbPassedArgs> sortedIndices = 
+        getSortedIndices<Any...>(passedLocalKeys);
+
+      // sort the local keys to get an idea of which ones are missing more easily
+      std::array<int64_t, nbPassedArgs> sortedPassedLocalKeys = {};
+      for (int i = 0; i < nbPassedArgs; ++i)
+      {
+        sortedPassedLocalKeys[i] = passedLocalKeys[sortedIndices[i]];
+      }
+      
+      // now form the padded index list
+      std::array<int64_t, nbFunctionKeys> outList = {};
+      for (int i = 0; i < nbPositionals; ++i)
+      {
+        outList[i] = KeyIdType::POSITIONAL;
+      }
+
+      int offset = 0;
+      for (int i = nbPositionals; i < nbFunctionKeys; ++i)
+      {
+        if (i-offset < nbPassedArgs && sortedPassedLocalKeys[i-offset] == i)
+        {
+          outList[i] = sortedIndices[i-offset];
+        }
+        else 
+        {
+          ++offset;
+          outList[i] = KeyIdType::ABSENT;
+        }
+      }
+
+      return outList;
+    }
+
+    /// returns a mask where bit i is set if function key i is passed, positionally or named
+    /// only the first 64 function keys are represented
+    template <class... Any>
+    constexpr inline static uint64_t getPresenceMask()
+    {
+      constexpr std::array<int64_t,sizeof...(TFunctionKeys)> paddedList = getPaddedList<Any...>();
+
+      uint64_t mask = 0;
+      for (int i = 0; i < (int)paddedList.size() && i < 64; ++i)
+      {
+        if (paddedList[i] != KeyIdType::ABSENT)
+        {
+          mask |= (uint64_t(1) << i);
+        }
+      }
+      return mask;
+    }
+
+    /// process arguments passed to operator()
+    /// reorders the argument addresses and fills absent fields with nullptr. If _invoker is
+    /// CanonicalCall, the shared callCanonical thunk is called, otherwise the reordered 
+    /// arguments are passed to _invoker
+    template <class... Any, class TInvoker, size_t... Is>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) internal3(TInvoker&& _invoker, Any&&... _args, 
+      std::index_sequence<Is...> const &) const
+    {
+      constexpr int nbPassedArgs = sizeof...(Any);
+      constexpr int nbFunctionKeys = sizeof...(TFunctionKeys);
+
+      constexpr std::array<int64_t,nbFunctionKeys> paddedList = getPaddedList<Any...>();
+
+      // now get Addresses
+      // plain arrays, std::array::operator[] is a function call in unoptimized builds.
+      // The last entry is unused, it avoids arrays of size zero
+      void* addresses[nbPassedArgs + 1] = { getAddress<Any>(_args)..., nullptr };
+
+      // padd them. put nullptr for absent args
+      // the indices are template arguments, so no index table is kept at runtime
+      void* paddedAddresses[nbFunctionKeys + 1] = 
+      { 
+        getPaddedAddress<Is,paddedList[Is]>(addresses)..., nullptr
+      };
+
+      typedef PositionalTuple<Any...> Positionals;
+
+      if constexpr (std::is_same<typename std::decay<TInvoker>::type, CanonicalCall>::value)
+      {
+        return callCanonical<Positionals>(paddedAddresses, 
+          std::integer_sequence<bool,(paddedList[Is] != KeyIdType::ABSENT)...>{}, 
+          std::index_sequence<Is...>{});
+      }
+      else 
+      {
+        return _invoker(getCanonicalArgument<Is,(paddedList[Is] != KeyIdType::ABSENT),
+          typename PositionalType<Is,Positionals>::type>(paddedAddresses[Is])...);
+      }
+      
+    }
+
+    template <typename DFunctionPtr = TFunctionPtr, 
+      std::enable_if_t<std::is_member_function_pointer<
+        typename FunctionPointerType<DFunctionPtr>::type>::value,bool> = true>
+    NAMEDPARAMS_FORCE_INLINE typename KeyFunctionTraits::ResultType call(
+      typename TFunctionKeys::type&&... _args) const
+    {
+      return (m_classPtr->*FunctionPointerType<TFunctionPtr>::get(m_baseFunction))(
+        _NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
+    }
+
+    template <typename DFunctionPtr = TFunctionPtr, 
+      std::enable_if_t<!std::is_member_function_pointer<
+        typename FunctionPointerType<DFunctionPtr>::type>::value,bool> = true>
+    NAMEDPARAMS_FORCE_INLINE typename KeyFunctionTraits::ResultType call(
+      typename TFunctionKeys::type&&... _args) const
+    {
+      return FunctionPointerType<TFunctionPtr>::get(m_baseFunction)(
+        _NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
+    }
+
+};
+
+template <class TFunctionPtr, class... TFunctionKeys>
+template <class... Any>
+typename KeyFunction<TFunctionPtr,TFunctionKeys...>::ResultType 
+KeyFunction<TFunctionPtr,TFunctionKeys...>::callDeclared(Any&&... _args) const
+{
+  return callInline<Any...>(_NAMEDPARAMS_FORWARD(Any, _args)...);
+}
+
+template <class DFunctionPtr, class... DFunctionKeys>
+KeyFunction(DFunctionPtr _function, const DFunctionKeys&... _keys) 
+  -> KeyFunction<DFunctionPtr,DFunctionKeys...>;
+
+template <class DFunctionPtr, class... DFunctionKeys>
+KeyFunction(typename DFunctionPtr::ClassType _classPtr, DFunctionPtr _function, 
+  const DFunctionKeys&... _keys) -> KeyFunction<DFunctionPtr,DFunctionKeys...>;
+
+/// KeyTemplateFunction calls a generic callable (e.g. a function object with a template 
+/// operator()) with positionals and named parameters, which are checked against the function
+/// type TSignature. Omitted optionals are passed as NamedParams::absent, so each combination 
+/// of present optionals is a separate instantiation of the callee, which can remove the 
+/// branches of absent arguments with if constexpr (IsAbsent<T>::value). 
+/// Optionals which are passed, even as std::nullopt, keep their type.
+/// Compile-time constants (NamedParams::constant<V>, passed as named parameter or positional) 
+/// are passed as std::integral_constant, so the callee is specialized for their value.
+template <class TCallable, class TSignature, class... TFunctionKeys>
+class KeyTemplateFunction
+{
+  private:
+
+    KeyFunction<TSignature*,TFunctionKeys...> m_signature;
+
+    TCallable m_callable;
+
+    /// the std::integral_constant passed as argument T, void for runtime values
+    template <class T>
+    struct PassedConstant
+    {
+      typedef void type;
+    };
+
+    template <class U, U V>
+    struct PassedConstant<std::integral_constant<U,V>>
+    {
+      typedef std::integral_constant<U,V> type;
+    };
+
+    template <class TKey, bool B, class C>
+    struct PassedConstant<AssignedKey<TKey,B,C>>
+    {
+      typedef C type;
+    };
 
+    /// key ID of argument T, -1 for positionals
+    template <class T>
+    constexpr inline static int64_t getPassedKeyID()
+    {
+      if constexpr (IsAssignedKey<T>::value)
+      {
+        return AssignedKeyType<T>::type::ID;
+      }
+      else 
+      {
+        return -1;
+      }
     }
 
-    /// returns a pair containing the number of positionals and named arguments
-    template <class... Any>
-    constexpr inline static std::pair<int,int> getNb() 
+    /// the std::integral_constant passed for function key Idx, void if there is none
+    template <size_t Idx, class... Any>
+    struct ConstantOfKey
     {
-      std::array<bool,sizeof...(Any)> types = 
+      constexpr static size_t getArgument()
       {
-        IsAssignedKey<Any>::value...
-      };
+        constexpr std::array<int64_t,sizeof...(Any) + 1> passedKeyIDs = 
+        { 
+          getPassedKeyID<typename std::decay<Any>::type>()..., -1 
+        };
+        constexpr int64_t keyID = std::tuple_element<Idx,std::tuple<TFunctionKeys...>>::type::ID;
 
-      std::pair<int,int> group = std::make_pair(0,0);
-      for (auto t : types)
-      {
-        if (!t)
+        for (size_t i = 0; i < sizeof...(Any); ++i)
         {
-          group.first++;
-        }
-        else 
-        {
-          group.second++;
+          // positionals are passed for the function keys in order
+          if (passedKeyIDs[i] == keyID || (passedKeyIDs[i] < 0 && i == Idx))
+          {
+            return i;
+          }
         }
+        return sizeof...(Any);
       }
 
-      return group;
+      typedef typename PassedConstant<typename std::decay<typename std::tuple_element<
+        getArgument(), std::tuple<Any..., void>>::type>::type>::type type;
+    };
 
+    /// passes the constant TConstant instead of the canonical argument, if there is one
+    template <class TConstant, class T>
+    inline static decltype(auto) markConstant(T&& _argument)
+    {
+      if constexpr (std::is_void<TConstant>::value)
+      {
+        return markAbsent(std::forward<T>(_argument));
+      }
+      else 
+      {
+        return TConstant{};
+      }
     }
 
-    /// struct to get the ID of a passed argument
-    /// if D is a non-Key, it is a positional
-    template <class D>
-    struct GetArgumentID 
+    template <class... Any, class TCanonical, size_t... Is>
+    inline decltype(auto) callCallable(TCanonical&& _canonical, 
+      std::index_sequence<Is...> const &) const
     {
-      const inline static int64_t ID = KeyIdType::POSITIONAL;
-    };
+      return m_callable(markConstant<typename ConstantOfKey<Is,Any...>::type>(
+        std::get<Is>(std::move(_canonical)))...);
+    }
 
-    template <class D>
-    struct GetArgumentID<AssignedKey<D>>
+    /// replaces std::nullopt_t, which KeyFunction::apply passes for omitted optionals
+    template <class T>
+    inline static decltype(auto) markAbsent(T&& _argument)
     {
-      const inline static int64_t ID = AssignedKey<D>::keyType::ID;
-    };
+      if constexpr (std::is_same<typename std::decay<T>::type, std::nullopt_t>::value)
+      {
+        return absent_t(0);
+      }
+      else 
+      {
+        return std::forward<T>(_argument);
+      }
+    }
 
-    /// checks if the positional type can be converted to the type needed by the function
-    template <class... Any, size_t... Is>
-    constexpr inline static std::array<bool,sizeof...(Is)> 
-    positionalConversion(std::index_sequence<Is...> const &) 
+  public:
+
+    constexpr KeyTemplateFunction(TCallable _callable, TSignature* _signature, 
+      const TFunctionKeys&... _keys)
+      : m_signature(_signature, _keys...)
+      , m_callable(std::move(_callable))
     {
-      constexpr std::array<bool,sizeof...(Is)> out = 
-      { 
-        std::is_convertible<
-          typename std::tuple_element<Is, std::tuple<Any...>>::type, 
-          typename KeyFunctionTraits::template arg<Is>::type
-        >::value...
-      };
+    }
 
-      // TODO: BETTER ERROR HANDLING: SHOW WHICH TYPES CANNOT BE CONVERTED
+    /// calls the callable with the reordered arguments
+    /// fails at compile time if passed arguments are invalid
+    template <class... Any, std::enable_if_t<
+      KeyFunction<TSignature*,TFunctionKeys...>::template evalAnyError<Any...>(), int> = 0>
+    inline decltype(auto) operator()(Any&&... _args) const
+    {
+      return m_signature.apply(
+        [this](auto&&... _canonical) -> decltype(auto)
+        {
+          return callCallable<Any...>(
+            std::forward_as_tuple(std::forward<decltype(_canonical)>(_canonical)...),
+            std::make_index_sequence<sizeof...(TFunctionKeys)>{});
+        }, 
+        std::forward<Any>(_args)...);
+    }
 
-      return out;
+};
+
+template <class DCallable, class DSignature, class... DFunctionKeys>
+KeyTemplateFunction(DCallable _callable, DSignature* _signature, const DFunctionKeys&... _keys) 
+  -> KeyTemplateFunction<DCallable,DSignature,DFunctionKeys...>;
+
+template <class TFunctionPtr, class TArgs>
+class KeyArgsFunction;
+
+/// NamedArgs is the single parameter of a function which reads its arguments by key instead of 
+/// by position, e.g. _args[kBasis] or _args.getOr(kScaling, 1.0). It holds the addresses of the 
+/// values passed by the caller, in the order of TFunctionKeys, and is filled by KeyArgsFunction.
+/// Keys are resolved at compile time, so a read is a single load through the stored address.
+/// The values are owned by the caller and only valid during the call
+template <class... TFunctionKeys>
+class NamedArgs
+{
+  private:
+
+    /// value type of TKey, without reference and const
+    template <class TKey>
+    using ValueType = typename std::remove_cv<
+      typename std::remove_reference<typename TKey::type>::type>::type;
+
+    /// value returned for omitted optionals of type T
+    template <class T>
+    const inline static T s_absent = T();
+
+    /// addresses of the passed values, nullptr for omitted optionals
+    std::array<void*,sizeof...(TFunctionKeys)> m_addresses;
+
+    NamedArgs()
+      : m_addresses{}
+    {
     }
-    
-    /// this function is used to evaluate the template parameters for operator()
-    /// that is: correct order, correct type, missing keys, invalid keys, duplicate keys...
-    /// returns an error containing some info depending on the context
-    template <class... Any>
-    constexpr inline static EvalReturn evalAny()
+
+    NamedArgs(const NamedArgs& _other) = delete;
+
+    NamedArgs& operator=(const NamedArgs& _other) = delete;
+
+    /// returns the position of TKey in TFunctionKeys, or sizeof...(TFunctionKeys) if the 
+    /// function does not take it
+    template <class TKey>
+    constexpr inline static size_t getIndex()
     {
+      return getKeyIndex<TKey, TFunctionKeys...>();
+    }
 
-      // get number of different arguments
-      constexpr auto group = getNb<Any...>();
-      constexpr int nbPositionalArgs = group.first;
-      constexpr int nbAssignedKeys = group.second;
-      constexpr int nbFunctionKeys = sizeof...(TFunctionKeys);
-      constexpr int nbPassedArgs = sizeof...(Any);
+    template <class TFunctionPtr, class TArgs>
+    friend class KeyArgsFunction;
 
-      // check if positional arguments are grouped together
-      constexpr std::array<bool,sizeof...(Any)> isKey = 
-      {
-        IsAssignedKey<Any>::value...
-      };
+  public:
 
-      for (int i = 1; i < nbPassedArgs; ++i)
+    /// returns the value passed for _key: a reference to the caller's object for reference keys,
+    /// a const reference otherwise. Optionals are returned as a const reference to the optional,
+    /// which is empty if the key was omitted
+    template <class TKey, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) operator[]([[maybe_unused]] const TKey& _key) const
+    {
+      constexpr size_t idx = getIndex<TKey>();
+      static_assert(idx < sizeof...(TFunctionKeys), "Key is not an argument of the function!");
+
+      typedef typename TKey::type T;
+      typedef ValueType<TKey> V;
+
+      if constexpr (IsOptional<V>::value)
       {
-        // key should not follow positional argument
-        if (isKey[i-1] && !isKey[i])
-        {
-          return EvalReturn{ErrorType::POSITIONAL_CANNOT_FOLLOW_KEY_ARGUMENT, i, 0};
-        }
+        return m_addresses[idx] ? *static_cast<const V*>(m_addresses[idx]) : s_absent<V>;
       }
-      
-      // check if positional arguments are correct types or convertible (Keys are set to always true)
-      std::array<bool,nbPositionalArgs> positionalIsConvertible = positionalConversion<Any...>(
-        std::make_index_sequence<nbPositionalArgs>());
-
-      for (int i = 0; i < nbPositionalArgs; ++i)
+      else if constexpr (std::is_lvalue_reference<T>::value)
       {
-        if (!positionalIsConvertible[i])
-        {
-          return EvalReturn{ErrorType::COULD_NOT_CONVERT_KEY_TYPE_TO_ARGUMENT_TYPE, i, 0};
-        }
+        return *static_cast<typename std::remove_reference<T>::type*>(m_addresses[idx]);
       }
-      
-      // check if keys are all correct types <----
-      // maybe in the constructor directly, probably better?
-    
-      // get relative/local key IDs
-      std::array<int64_t, nbFunctionKeys> functionLocalKeyIDs = {};
-      
-      for (int i = 0; i < nbFunctionKeys; ++i) 
+      else 
       {
-        functionLocalKeyIDs[i] = i;
+        return *static_cast<const V*>(m_addresses[idx]);
       }
-      
-      constexpr std::array<int64_t, nbPassedArgs> passedLocalKeyIDs = getLocalKeyIDs<Any...>();
-      
-      std::array<bool,nbFunctionKeys> functionKeyIsOptional = {
-        IsOptional<typename TFunctionKeys::type>::value...};
+    }
 
-      int nbRequiredKeys = 0;
-      for (auto fOpt : functionKeyIsOptional)
-      { 
-        nbRequiredKeys += (fOpt) ? 0 : 1;
-      }
-      
-      // if no args passed, but function has required keys, throw error 
-      // (e.g. funcWrapper() -> func(int))
-      if (nbRequiredKeys != 0 && nbPassedArgs == 0)
+    /// returns true if _key has a value, i.e. is required or an optional which was passed and 
+    /// is not std::nullopt
+    template <class TKey, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    NAMEDPARAMS_FORCE_INLINE bool has(const TKey& _key) const
+    {
+      if constexpr (IsOptional<ValueType<TKey>>::value)
       {
-        return EvalReturn{ErrorType::MISSING_KEY, 0, 0};
+        return (*this)[_key].has_value();
       }
-
-      // if func only has optional arguments, and no args were passed we can return immediately
-      // e.g. funcWrapper() -> func(std::optional<int>)
-      if (nbRequiredKeys == 0 && nbPassedArgs == 0)
+      else 
       {
-        return EvalReturn{ErrorType::NONE, 0, 0};
+        static_assert(getIndex<TKey>() < sizeof...(TFunctionKeys), 
+          "Key is not an argument of the function!");
+        return true;
       }
+    }
 
-      // if all required keys in positional arguments, and no keys -> return
-      // e.g. funcWrapper(1,2,3) -> func(int, int, std::optional)
-      if (nbRequiredKeys <= nbPositionalArgs && nbAssignedKeys == 0)
+    /// returns the value of the optional _key, or _default if it has no value
+    template <class TKey, class D, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    NAMEDPARAMS_FORCE_INLINE auto getOr(const TKey& _key, D&& _default) const
+    {
+      static_assert(IsOptional<ValueType<TKey>>::value, "getOr needs an optional key!");
+
+      typedef typename std::remove_cv<typename std::remove_reference<
+        decltype(*std::declval<const ValueType<TKey>&>())>::type>::type R;
+
+      const ValueType<TKey>& value = (*this)[_key];
+      if (value)
       {
-        return EvalReturn{ErrorType::NONE, 0, 0};
+        return R(*value);
       }
+      return R(std::forward<D>(_default));
+    }
 
-      // check if unknown key present
-      for (int i = nbPositionalArgs; i < nbPassedArgs; ++i)
+};
+
+/// KeyArgsFunction wraps a function which takes a single const NamedArgs<TFunctionKeys...>&.
+/// Calls are checked like the calls of a KeyFunction with the same keys, but the arguments are 
+/// not reordered into the parameter list of the callee: the address of each argument is stored 
+/// in one NamedArgs in the frame of the caller, which is passed as a single pointer. Positionals 
+/// are first converted to the type of their key. For wide signatures this replaces marshaling 
+/// every argument into registers and onto the stack with one store per passed argument.
+template <class TFunctionPtr, class... TFunctionKeys>
+class KeyArgsFunction<TFunctionPtr,NamedArgs<TFunctionKeys...>>
+{
+  private:
+
+    /// only used for the compile-time checks and to find the position of the named parameters
+    typedef KeyFunction<void(*)(typename TFunctionKeys::type...), 
+      typename std::remove_cv<TFunctionKeys>::type...> Signature;
+
+    TFunctionPtr m_function;
+
+    /// assigned to a named parameter, returns it unchanged
+    struct ForwardNamed
+    {
+      template <class T>
+      NAMEDPARAMS_FORCE_INLINE T&& operator=(T&& _arg) const
       {
-        if (passedLocalKeyIDs[i] == KeyIdType::UNKNOWN) 
-        {
-          return EvalReturn{ErrorType::INVALID_KEY,i,1};
-        }
+        return _NAMEDPARAMS_FORWARD(T, _arg);
       }
+    };
 
-      // now sort the Key IDs for checking correct keys 
+    /// argument nr. Idx of type T is assigned to its type: positionals to the function key nr. Idx, 
+    /// named parameters to ForwardNamed
+    template <size_t Idx, class T, bool = IsAssignedKey<typename std::decay<T>::type>::value>
+    struct ArgumentTarget
+    {
+      typedef ForwardNamed type;
+    };
 
-      constexpr auto sortIndex = getSortedIndices<Any...>(passedLocalKeyIDs);
+    template <size_t Idx, class T>
+    struct ArgumentTarget<Idx,T,false>
+    {
+      typedef typename std::remove_cv<typename std::tuple_element<Idx,
+        std::tuple<TFunctionKeys...>>::type>::type type;
+    };
 
-      std::array<int64_t,nbPassedArgs> passedSortedKeyIDs = {};
+    template <class... TNamed, size_t... Is>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) callNamed(std::index_sequence<Is...> const &, 
+      TNamed&&... _named) const
+    {
+      constexpr std::array<int64_t,sizeof...(TNamed)> localKeyIDs = 
+        Signature::template getLocalKeyIDs<typename std::decay<TNamed>::type...>();
 
-      for (int i = 0; i < nbPassedArgs; ++i)
+      NamedArgs<TFunctionKeys...> args;
+      ((args.m_addresses[localKeyIDs[Is]] = Signature::getAddress(_named)), ...);
+
+      return FunctionPointerType<TFunctionPtr>::get(m_function)(args);
+    }
+
+    template <class... Any, size_t... Is>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) callPositionals(
+      std::index_sequence<Is...> const & _sequence, Any&&... _args) const
+    {
+      // positionals are assigned in this full-expression, so temporaries created by their 
+      // conversion live until the call returns
+      return callNamed(_sequence, 
+        (typename ArgumentTarget<Is,Any>::type() = _NAMEDPARAMS_FORWARD(Any, _args))...);
+    }
+
+  public:
+
+    typedef typename FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type>::ResultType 
+      ResultType;
+
+    constexpr explicit KeyArgsFunction(TFunctionPtr _function)
+      : m_function(_function)
+    {
+    }
+
+    /// calls the function with positionals and named parameters
+    /// fails at compile time if passed arguments are invalid
+    template <class... Any, std::enable_if_t<Signature::template evalAnyError<Any...>(), int> = 0>
+    NAMEDPARAMS_FORCE_INLINE ResultType operator()(Any&&... _args) const
+    {
+      return callPositionals(std::index_sequence_for<Any...>{}, 
+        _NAMEDPARAMS_FORWARD(Any, _args)...);
+    }
+
+};
+
+template <class DFunctionPtr>
+KeyArgsFunction(DFunctionPtr _function) -> KeyArgsFunction<DFunctionPtr, 
+  typename std::decay<typename FunctionTraits<typename std::remove_pointer<DFunctionPtr>::type>
+    ::template arg<0>::type>::type>;
+
+/// NamedFunctionRef is a non-owning reference to a KeyFunction with the keys TFunctionKeys, or
+/// to any callable which accepts their types and returns R. Implementations with the same keys
+/// can be exchanged at runtime, and are called with the same checked named call syntax.
+/// A call reorders the arguments like a KeyFunction and then makes a single indirect call, 
+/// nothing is allocated. The referenced object has to outlive the NamedFunctionRef
+template <class R, class... TFunctionKeys>
+class NamedFunctionRef
+{
+  private:
+
+    typedef R (*SignaturePtr)(typename TFunctionKeys::type...);
+
+    /// only used for the compile-time checks and the reordering of the arguments
+    typedef KeyFunction<SignaturePtr,typename std::remove_cv<TFunctionKeys>::type...> Signature;
+
+    /// referenced object, function pointers are stored separately because they cannot be
+    /// converted to void pointers
+    union Target
+    {
+      const void* object;
+      SignaturePtr function;
+    };
+
+    typedef R (*Thunk)(Target, typename TFunctionKeys::type&&...);
+
+    constexpr inline static Signature s_signature = 
+      Signature(static_cast<SignaturePtr>(nullptr), 
+        typename std::remove_cv<TFunctionKeys>::type()...);
+
+    Target m_target;
+
+    Thunk m_thunk;
+
+    /// the result of the target is discarded if R is void
+    template <class TKeyFunction>
+    static R callKeyFunction(Target _target, typename TFunctionKeys::type&&... _args)
+    {
+      if constexpr (std::is_void<R>::value)
       {
-        passedSortedKeyIDs[i] = passedLocalKeyIDs[sortIndex[i]];
+        static_cast<const TKeyFunction*>(_target.object)->call(
+          _NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
+      }
+      else
+      {
+        return static_cast<const TKeyFunction*>(_target.object)->call(
+          _NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
       }
+    }
 
-      //_sort(passedLocalKeyIDs.begin(), passedLocalKeyIDs.end());
+    template <class TCallable>
+    static R callCallable(Target _target, typename TFunctionKeys::type&&... _args)
+    {
+      if constexpr (std::is_void<R>::value)
+      {
+        (*static_cast<const TCallable*>(_target.object))(
+          _NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
+      }
+      else
+      {
+        return (*static_cast<const TCallable*>(_target.object))(
+          _NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
+      }
+    }
+
+    static R callFunction(Target _target, typename TFunctionKeys::type&&... _args)
+    {
+      return _target.function(_NAMEDPARAMS_FORWARD(typename TFunctionKeys::type, _args)...);
+    }
+
+  public:
+
+    /// refers to a KeyFunction with the same keys
+    template <class TFunctionPtr>
+    NamedFunctionRef(
+      const KeyFunction<TFunctionPtr,typename std::remove_cv<TFunctionKeys>::type...>& _function)
+      : m_thunk(&callKeyFunction<
+          KeyFunction<TFunctionPtr,typename std::remove_cv<TFunctionKeys>::type...>>)
+    {
+      static_assert(std::is_convertible<typename KeyFunction<TFunctionPtr,
+          typename std::remove_cv<TFunctionKeys>::type...>::ResultType, R>::value
+        || std::is_void<R>::value, "KeyFunction result cannot be converted to R!");
+      m_target.object = &_function;
+    }
+
+    /// refers to a function with exactly the argument types of the keys
+    NamedFunctionRef(SignaturePtr _function)
+      : m_thunk(&callFunction)
+    {
+      m_target.function = _function;
+    }
+
+    /// refers to a callable (e.g. a lambda) which accepts the argument types of the keys
+    template <class TCallable, std::enable_if_t<
+      !std::is_same<typename std::decay<TCallable>::type, NamedFunctionRef>::value
+      && std::is_invocable_r<R, const TCallable&, typename TFunctionKeys::type&&...>::value, 
+      int> = 0>
+    NamedFunctionRef(const TCallable& _callable)
+      : m_thunk(&callCallable<TCallable>)
+    {
+      m_target.object = &_callable;
+    }
+
+    /// calls the referenced function with positionals and named parameters
+    /// fails at compile time if passed arguments are invalid
+    template <class... Any, std::enable_if_t<Signature::template evalAnyError<Any...>(), int> = 0>
+    NAMEDPARAMS_FORCE_INLINE R operator()(Any&&... _args) const
+    {
+      return s_signature.apply(
+        [this](auto&&... _canonical) -> R
+        {
+          return m_thunk(m_target, _NAMEDPARAMS_FORWARD(decltype(_canonical), _canonical)...);
+        },
+        _NAMEDPARAMS_FORWARD(Any, _args)...);
+    }
+
+};
+
+/// KeyAggregate initializes an aggregate struct from positionals and named parameters.
+/// The member keys have to be listed in the same order as the members of the struct. 
+/// Arguments are checked by the same compile-time machinery as in KeyFunction, and each member 
+/// is initialized directly from the value stored in the assigned key. 
+/// Absent optional members are initialized with std::nullopt.
+template <class TStruct, class... TMemberKeys>
+class KeyAggregate
+{
+  private:
+
+    /// signature of the aggregate initialization, only used for the compile-time checks
+    typedef KeyFunction<void(*)(typename TMemberKeys::type...), TMemberKeys...> Signature;
+
+    typedef std::tuple<typename TMemberKeys::type...> MemberTypes;
+
+    /// returns the value used to initialize member nr. Idx
+    /// ArgIdx is the position of the argument as given by KeyFunction::getPaddedList
+    template <size_t Idx, int64_t ArgIdx, class TTuple>
+    inline static decltype(auto) getMember([[maybe_unused]] TTuple& _args)
+    {
+      using MemberType = typename std::tuple_element<Idx, MemberTypes>::type;
 
-       // check for multiple keys of same type
-      for (int i = nbPositionalArgs+1; i < nbPassedArgs; ++i)
+      if constexpr (ArgIdx == Signature::KeyIdType::ABSENT)
       {
-        if (passedSortedKeyIDs[i-1] == passedSortedKeyIDs[i])
-        {
-          return EvalReturn{ErrorType::SAME_KEY_PASSED_MORE_THAN_ONCE, static_cast<int>(sortIndex[i-1]), 1};
-        }
+        return std::nullopt;
       }
-
-      int offset = 0;
-      
-      for (int iArg = nbPositionalArgs; iArg < nbFunctionKeys; ++iArg)
+      else if constexpr (ArgIdx == Signature::KeyIdType::POSITIONAL)
       {
-        // no more passed keys to parse, and function key is NOT optional
-        if (iArg >= nbPassedArgs+offset && !functionKeyIsOptional[iArg])
-        {
-          return EvalReturn{ErrorType::MISSING_KEY, iArg, 0};
-        }
-        // no more passed keys to parse and function key IS optional 
-        else if (iArg >= nbPassedArgs+offset && functionKeyIsOptional[iArg])
-        {
-          continue;
-        }
-        // function key should never be larger than the pass key
-        else if (functionLocalKeyIDs[iArg] > passedSortedKeyIDs[iArg-offset])
-        {
-          return EvalReturn{ErrorType::INVALID_KEY, static_cast<int>(sortIndex[iArg-offset]), 1};
-        }
-        // if the function key is smaller, some key might be missing - check if optional
-        else if (functionLocalKeyIDs[iArg] < passedSortedKeyIDs[iArg-offset] 
-                 && !functionKeyIsOptional[iArg])
+        using ArgType = typename std::tuple_element<Idx, TTuple>::type;
+        
+        // convert positionals beforehand to avoid narrowing in the braced initialization
+        if constexpr (std::is_same<typename std::decay<ArgType>::type, 
+                                   typename std::decay<MemberType>::type>::value)
         {
-          return EvalReturn{ErrorType::MISSING_KEY, iArg, 0};
+          return std::forward<ArgType>(std::get<Idx>(_args));
         }
-        // same as above. but incrementing offset
-        else if (functionLocalKeyIDs[iArg] < passedSortedKeyIDs[iArg-offset] 
-        && functionKeyIsOptional[iArg])
+        else 
         {
-          offset++;
+          return static_cast<typename std::decay<MemberType>::type>(
+            std::forward<ArgType>(std::get<Idx>(_args)));
         }
       }
-
-      return EvalReturn{ErrorType::NONE, 0, 0};
-    
-    }
-    
-    /// Encapsulates evalAny() and handes the error
-    /// returns true if class... Any is compatible with the function
-    template <class... Any>
-    constexpr inline static bool evalAnyError()
-    {
-      // check for too many args to avoid further error messages and clogging up compiler output
-      if constexpr (sizeof...(Any) > sizeof...(TFunctionKeys))
-      {
-        failWithMessage<ErrorType::TOO_MANY_ARGUMENTS_PASSED_TO_FUNCTION, sizeof...(Any),
-          sizeof...(TFunctionKeys)>();
-        return false;
-      } 
       else 
       {
+        return std::forward<MemberType>(*std::get<ArgIdx>(_args).getValue());
+      }
+    }
 
-        constexpr EvalReturn error = evalAny<Any...>();
-      
-        if constexpr (error.errorType != ErrorType::NONE)
-        {
-          constexpr size_t idx = static_cast<size_t>(error.id);
+    template <class... Any, class TTuple, size_t... Is>
+    inline static TStruct internalInit(TTuple&& _args, std::index_sequence<Is...> const &)
+    {
+      constexpr std::array<int64_t,sizeof...(TMemberKeys)> paddedList = 
+        Signature::template getPaddedList<Any...>();
       
-          if constexpr ( error.isFuncID == 0 )
-          {
-            using KeyType = typename std::tuple_element<idx, std::tuple<TFunctionKeys...> >::type;
-            constexpr auto keyName = KeyType::name;
-            failWithMessage<error.errorType, keyName>();
-          }
-          else if constexpr ( error.isFuncID > 0) 
-          {
-            using KeyType = typename std::tuple_element<idx, std::tuple<Any...> >::type::keyType;
-            constexpr auto keyName = KeyType::name;
-            failWithMessage<error.errorType, keyName>();
-          }
-          else 
-          {
-            failWithMessage<error.errorType, error.id>();
-          }
-          return false;
-        }
-      }      
-
-      return true;
+      return TStruct{ getMember<Is, paddedList[Is]>(_args)... };
     }
-    
-    /// call to the internal function pointer using positionals and named parameters
+
+  public:
+
+    /// initializes the struct using positionals, named parameters and optionals
     /// fails at compile time if passed arguments are invalid
-    template <class... Any, std::enable_if_t<evalAnyError<Any...>(), int> = 0>
-    inline typename KeyFunctionTraits::ResultType operator()(Any&&... _args) const 
+    template <class... Any, std::enable_if_t<Signature::template evalAnyError<Any...>(), int> = 0>
+    inline static TStruct init(Any&&... _args)
     {
-      return internal3<Any...>(std::forward<Any>(_args)..., std::make_index_sequence<sizeof...(TFunctionKeys)>{});
+      return internalInit<Any...>(std::forward_as_tuple(std::forward<Any>(_args)...), 
+        std::make_index_sequence<sizeof...(TMemberKeys)>{});
     }
 
-    /// return internal address in assigned key
-    template <typename T, std::enable_if_t<IsAssignedKey<T>::value,bool> = true>
-    inline void* getAddress(T& _assignedKey) const
+};
+
+/// initializes an aggregate struct declared with NAMEDPARAMS_AGGREGATE using named parameters
+template <class TStruct, class... Any>
+inline TStruct np_init(Any&&... _args)
+{
+  return TStruct::NamedParamsAggregate::init(std::forward<Any>(_args)...);
+}
+
+/// type traits of a pointer to a data member
+template <class T>
+struct MemberPointerTraits;
+
+template <class C, class M>
+struct MemberPointerTraits<M C::*>
+{
+  typedef C ClassType;
+  typedef M MemberType;
+};
+
+/// MemberKey is a key bound to the data member TMember (e.g. &Settings::scfMaxIter).
+/// np_update assigns the values of several member keys to an existing object.
+template <auto TMember, int64_t UNIQUE_ID, auto E> 
+class MemberKey
+{
+  static_assert(std::is_member_object_pointer<decltype(TMember)>::value, 
+    "MemberKey has to be bound to a data member!");
+  static_assert(UNIQUE_ID >= 0, "Key has to have an ID greater or equal zero!");
+
+  public:
+
+    typedef typename MemberPointerTraits<decltype(TMember)>::ClassType ClassType;
+
+    typedef typename std::remove_cv<
+      typename MemberPointerTraits<decltype(TMember)>::MemberType>::type type;
+
+    constexpr MemberKey() {}
+
+    MemberKey(const MemberKey& _other) = delete;
+
+    MemberKey(MemberKey&& _other) = delete;
+
+    auto operator=(type _any) const
     {
-      return (void*)_assignedKey.getValue();
+      return AssignedKey<MemberKey>::template build<type>(std::move(_any));
     }
 
-    /// return address of passed value
-    template <typename T, std::enable_if_t<!IsAssignedKey<T>::value,int> = 0>
-    inline void* getAddress(T& _value) const
+    constexpr static decltype(TMember) member = TMember;
+
+    static inline const int64_t ID = UNIQUE_ID;
+
+    static inline auto const name = E;
+
+};
+
+template <class T>
+struct IsMemberKey : public std::false_type {};
+
+template <auto TMember, int64_t N, auto E>
+struct IsMemberKey<MemberKey<TMember,N,E>> : public std::true_type {};
+
+/// true if TArg is an assigned member key of a member of TObject
+template <class TObject, class TArg>
+constexpr inline bool _isMemberKeyOf()
+{
+  if constexpr (IsAssignedKey<TArg>::value)
+  {
+    typedef typename AssignedKeyType<TArg>::type KeyType;
+    if constexpr (IsMemberKey<KeyType>::value)
     {
-      return (void*)&_value;
+      return std::is_base_of<typename KeyType::ClassType, TObject>::value;
     }
+  }
+  return false;
+}
 
-    /// utility struct to get the type nr. Idx in the function
-    /// if the key is absent, the type defaults to nullopt_t
-    template <int Idx, int KeyID>
-    struct ConvertToType
-    {
-      using type = typename KeyFunctionTraits::template arg<Idx>::type;
-    };
+/// returns the position of the first argument which is not an assigned member key of TObject
+template <class TObject, class... Any>
+constexpr inline int _findInvalidMemberKey()
+{
+  constexpr std::array<bool,sizeof...(Any)> isValid = 
+  {
+    _isMemberKeyOf<TObject, typename std::remove_reference<Any>::type>()...
+  };
 
-    /// utility struct to get the type nr. Idx in the function
-    /// if the key is absent, the type defaults to nullopt_t
-    template <int Idx>
-    struct ConvertToType<Idx,KeyIdType::ABSENT>
+  for (int i = 0; i < (int)sizeof...(Any); ++i)
+  {
+    if (!isValid[i])
     {
-      using type = std::nullopt_t;
-    };
+      return i;
+    }
+  }
+  return -1;
+}
 
-    /// process arguments passed to operator()
-    /// reorders the arguments to pass it to the internal function and fills absent fields with nullopts
-    template <class... Any, size_t... Is>
-    typename KeyFunctionTraits::ResultType internal3(Any&&... _args, std::index_sequence<Is...> const &) const
+/// checks the arguments of np_update, fails at compile time if they are invalid
+template <class TObject, class... Any>
+constexpr inline bool _updateIsValid()
+{
+  constexpr int invalidKey = _findInvalidMemberKey<TObject,Any...>();
+  if constexpr (invalidKey >= 0)
+  {
+    failWithMessage<ErrorType::INVALID_KEY, invalidKey>();
+    return false;
+  }
+  else 
+  {
+    constexpr int duplicateKey = MultipleIdenticalKeys<
+      typename AssignedKeyType<typename std::remove_reference<Any>::type>::type...>();
+    if constexpr (duplicateKey >= 0)
     {
+      failWithMessage<ErrorType::SAME_KEY_PASSED_MORE_THAN_ONCE, duplicateKey>();
+      return false;
+    }
+  }
+  return true;
+}
 
-      auto constexpr group = getNb<Any...>();
-      constexpr int nbPositionals = group.first;
-      constexpr int nbPassedArgs = sizeof...(Any);
-      constexpr int nbFunctionKeys = sizeof...(TFunctionKeys);
+/// assigns the values of the member keys to the members of an existing object. 
+/// The values are moved from the assigned keys into the members, the object is not copied.
+/// e.g. np_update(settings, kScfMaxIter = 50, kScaling = 2.0)
+template <class TObject, class... Any>
+inline TObject& np_update(TObject& _object, Any&&... _args)
+{
+  if constexpr (_updateIsValid<TObject,Any...>())
+  {
+    ((_object.*(AssignedKeyType<typename std::remove_reference<Any>::type>::type::member) 
+      = std::move(*_args.getValue())), ...);
+  }
 
-      // potentially unordered local key
-      // "local" meaning relative to function keys
-      // e.g. for keys passed to KeyFunction (1515, 845, 1233) 
-      //      keys passed to function (845, 1515) become (1,0)
-      constexpr std::array<int64_t,nbPassedArgs> passedLocalKeys = getLocalKeyIDs<Any...>();
+  return _object;
+}
 
-      // get indices which will sort the local keys
-      // indices[i] will give you the position in the arg list of key with id=i 
-      // (positionals still have id=-1)
-      constexpr std::array<int64_t,nbPassedArgs> sortedIndices = 
-        getSortedIndices<Any...>(passedLocalKeys);
+/// NamedResult holds multiple return values of a function, which are accessed with their keys 
+/// (result[kKey]) or with structured bindings, in the order of the keys. 
+/// It is initialized like an aggregate with positionals, named parameters and optionals, 
+/// and the values are constructed in place. Returning it by value from a (parametrized)
+/// function constructs it directly in the storage of the caller.
+template <class... TResultKeys>
+class NamedResult
+{
+  private:
 
-      // sort the local keys to get an idea of which ones are missing more easily
-      constexpr auto sortByIndex = [](auto& _indices, const auto& _array)
-      {
-        std::array<int64_t, nbPassedArgs> out = {};
-        for (size_t i = 0; i < _indices.size(); ++i)
-        {
-          out[i] = _array[_indices[i]];
-        }
-        return out;
-      };
+    typedef std::tuple<typename TResultKeys::type...> ValueTuple;
 
-      constexpr std::array<int64_t,nbPassedArgs> sortedPassedLocalKeys 
-        = sortByIndex(sortedIndices, passedLocalKeys);
-      
-      // now form a padded index list
-      // paddedList[i] will return the position of key with id=i in the argument list
-      // if entry is -1, it is a positional
-      // if entry is -3, it is not present in the argument list
-      constexpr auto getPaddedList = [](auto& _sortedKeys, auto& _indices)
-      {
-        std::array<int64_t, nbFunctionKeys> outList = {};
-        for (int i = 0; i < nbPositionals; ++i)
-        {
-          outList[i] = KeyIdType::POSITIONAL;
-        }
+    /// only used for the compile-time checks of the constructor
+    typedef KeyFunction<void(*)(typename TResultKeys::type...), 
+      typename std::remove_cv<TResultKeys>::type...> Signature;
 
-        int offset = 0;
-        for (int i = nbPositionals; i < nbFunctionKeys; ++i)
-        {
-          if (i-offset < nbPassedArgs && _sortedKeys[i-offset] == i)
-          {
-            outList[i] = _indices[i-offset];
-          }
-          else 
-          {
-            ++offset;
-            outList[i] = KeyIdType::ABSENT;
-          }
-        }
+    ValueTuple m_values;
 
-        return outList;
-      };
+    /// returns the position of TKey in TResultKeys, or sizeof...(TResultKeys) if it is not part
+    /// of the result
+    template <class TKey>
+    constexpr inline static size_t getIndex()
+    {
+      return getKeyIndex<TKey, TResultKeys...>();
+    }
 
-      constexpr std::array<int64_t,nbFunctionKeys> paddedList = 
-        getPaddedList(sortedPassedLocalKeys,sortedIndices);
+  public:
 
-      // now get Addresses
-      std::array<void*,nbPassedArgs> addresses = { (void*)getAddress<Any>(_args)... };
+    /// initializes the values using positionals, named parameters and optionals
+    /// only takes part in overload resolution if the passed arguments are valid, so traits 
+    /// like std::is_constructible and conversions of other types do not fail to compile
+    template <class... Any, std::enable_if_t<sizeof...(Any) != 1
+      && Signature::template isValidArgumentList<Any...>(), int> = 0>
+    NamedResult(Any&&... _args)
+      : m_values(KeyAggregate<ValueTuple,TResultKeys...>::init(std::forward<Any>(_args)...))
+    {
+    }
 
-      // padd them. put nullptr for absent args
-      std::array<void*,nbFunctionKeys> paddedAddresses = {};
+    /// a single argument does not convert implicitly, e.g. from the value of the first key
+    template <class D, std::enable_if_t<
+      !std::is_same<typename std::decay<D>::type,NamedResult>::value
+      && Signature::template isValidArgumentList<D>(), int> = 0>
+    explicit NamedResult(D&& _arg)
+      : m_values(KeyAggregate<ValueTuple,TResultKeys...>::init(std::forward<D>(_arg)))
+    {
+    }
 
-      for (int i = 0; i < nbPositionals; ++i)
-      {
-        paddedAddresses[i] = addresses[i];
-      }      
+    /// returns the value of _key
+    template <class TKey, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    decltype(auto) operator[]([[maybe_unused]] const TKey& _key) 
+    {
+      static_assert(getIndex<TKey>() < sizeof...(TResultKeys), "Key is not part of NamedResult!");
+      return std::get<getIndex<TKey>()>(m_values);
+    }
 
-      for (int i = nbPositionals; i < nbFunctionKeys; ++i)
-      {
-        int idx = paddedList[i];
-        paddedAddresses[i] = (idx == KeyIdType::ABSENT) ? m_nullOpt : addresses[paddedList[i]];
-      }
+    template <class TKey, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    decltype(auto) operator[]([[maybe_unused]] const TKey& _key) const
+    {
+      static_assert(getIndex<TKey>() < sizeof...(TResultKeys), "Key is not part of NamedResult!");
+      return std::get<getIndex<TKey>()>(m_values);
+    }
 
-      return call(std::forward<typename ConvertToType<Is,paddedList[Is]>::type>
-                  (
-                    *((typename std::remove_reference<
-                       typename ConvertToType<Is,paddedList[Is]>::type>::type*)
-                      (paddedAddresses[Is]))
-                  )...);
-      
+    /// access by position, used by structured bindings
+    template <size_t Idx>
+    decltype(auto) get() &
+    {
+      return std::get<Idx>(m_values);
     }
 
-    template <typename DFunctionPtr = TFunctionPtr, 
-      std::enable_if_t<std::is_member_function_pointer<DFunctionPtr>::value,bool> = true>
-    inline typename KeyFunctionTraits::ResultType call(typename TFunctionKeys::type&&... _args) const
+    template <size_t Idx>
+    decltype(auto) get() const &
     {
-      return (m_classPtr->*m_baseFunction)(std::forward<typename TFunctionKeys::type>(_args)...);
+      return std::get<Idx>(m_values);
     }
 
-    template <typename DFunctionPtr = TFunctionPtr, 
-      std::enable_if_t<!std::is_member_function_pointer<DFunctionPtr>::value,bool> = true>
-    inline typename KeyFunctionTraits::ResultType call(typename TFunctionKeys::type&&... _args) const
+    template <size_t Idx>
+    decltype(auto) get() &&
     {
-      return m_baseFunction(std::forward<typename TFunctionKeys::type>(_args)...);
+      return std::get<Idx>(std::move(m_values));
     }
 
 };
 
-template <class DFunctionPtr, class... DFunctionKeys>
-KeyFunction(DFunctionPtr _function, const DFunctionKeys&... _keys) 
-  -> KeyFunction<DFunctionPtr,DFunctionKeys...>;
-
-template <class DFunctionPtr, class... DFunctionKeys>
-KeyFunction(typename DFunctionPtr::ClassType _classPtr, DFunctionPtr _function, 
-  const DFunctionKeys&... _keys) -> KeyFunction<DFunctionPtr,DFunctionKeys...>;
-
 #define INT64_T_MAX 9223372036854775807UL
 #define UINT64_T_MAX 18446744073709551615UL
 
@@ -1039,8 +3388,62 @@ constexpr int64_t uniqueID(const char* seed)
 
 }
 
+/// start value of fnv1a hashes
+constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+/// FNV-1a hash of the 8 bytes of _word (lowest byte first), continuing from _hash
+constexpr uint64_t fnv1a(uint64_t _hash, uint64_t _word)
+{
+  for (int byte = 0; byte < 8; ++byte)
+  {
+    _hash ^= (_word >> (8 * byte)) & 0xff;
+    _hash *= 0x100000001b3ULL;
+  }
+  return _hash;
+}
+
+/// FNV-1a hash of the characters of the null terminated _string, continuing from _hash
+constexpr uint64_t fnv1a(uint64_t _hash, const char* _string)
+{
+  for (size_t i = 0; _string[i] != '\0'; ++i)
+  {
+    _hash ^= static_cast<unsigned char>(_string[i]);
+    _hash *= 0x100000001b3ULL;
+  }
+  return _hash;
+}
+
+/// FNV-1a hash of the _size bytes at _data, continuing from _hash
+inline uint64_t fnv1a(uint64_t _hash, const void* _data, size_t _size)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(_data);
+  for (size_t i = 0; i < _size; ++i)
+  {
+    _hash ^= bytes[i];
+    _hash *= 0x100000001b3ULL;
+  }
+  return _hash;
+}
+
+_NAMEDPARAMS_END_INSTRUMENTED
 } // end namespace NamedParams
 
+/// structured bindings for NamedResult
+namespace std
+{
+
+template <class... TResultKeys>
+struct tuple_size<NamedParams::NamedResult<TResultKeys...>>
+  : public std::integral_constant<size_t, sizeof...(TResultKeys)> {};
+
+template <size_t Idx, class... TResultKeys>
+struct tuple_element<Idx, NamedParams::NamedResult<TResultKeys...>>
+{
+  using type = typename std::tuple_element<Idx, std::tuple<typename TResultKeys::type...>>::type;
+};
+
+} // end namespace std
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ///                                       MACRO MAGIC
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1056,7 +3459,7 @@ constexpr int64_t uniqueID(const char* seed)
 #define _NAMEDPARAMS_STRINGIFY(x) #x
 #define _NAMEDPARAMS_TOSTRING(x) _NAMEDPARAMS_STRINGIFY(x)
 #define NAMEDPARAMS_UNIQUE(name) \
-  NamedParams::uniqueID(#name _NAMEDPARAMS_TOSTRING(__LINE__) __TIME__ __DATE__)
+  NamedParams::uniqueID(#name _NAMEDPARAMS_TOSTRING(__LINE__))
 
 #define NAMEDPARAMS_PARAM(name, ...) \
   enum _ENUM_##name {     \
@@ -1205,15 +3608,125 @@ constexpr int64_t uniqueID(const char* seed)
 
 #define NAMEDPARAMS_CLASS_PARAMETRIZE(functionName, function, list) \
   NAMEDPARAMS_DECLARE_KEYS(function, list)\
-  NamedParams::KeyFunction<decltype(function), \
+  NamedParams::KeyFunction<NamedParams::FunctionConstant<function>, \
     _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_DECLTYPE, (,), (), function, list)> \
     functionName;
 
 #define NAMEDPARAMS_INIT_CLASS_FUNCTION(functionName, function, list) \
-  functionName(this, function, _NAMEDPARAMS_UNPAREN list)
+  functionName(this, NamedParams::FunctionConstant<function>{}, _NAMEDPARAMS_UNPAREN list)
+
+#define _NAMEDPARAMS_APPLY(macro, args) macro args
+
+#define _NAMEDPARAMS_GEN_MEMBER_KEY_IMPL(structName, name, member) \
+  enum _ENUM_##name {     \
+    _KEY_##name           \
+  };                      \
+  const inline static NamedParams::Key<decltype(structName::member), \
+    NAMEDPARAMS_UNIQUE(name), _KEY_##name> name; 
+
+#define _NAMEDPARAMS_GEN_MEMBER_KEY(structName, pair, i, nele) \
+  _NAMEDPARAMS_APPLY(_NAMEDPARAMS_GEN_MEMBER_KEY_IMPL, (structName, _NAMEDPARAMS_UNPAREN pair))
+
+#define _NAMEDPARAMS_MEMBER_DECLTYPE_IMPL(structName, name, member) \
+  decltype(name)
+
+#define _NAMEDPARAMS_MEMBER_DECLTYPE(structName, pair, i, nele) \
+  _NAMEDPARAMS_APPLY(_NAMEDPARAMS_MEMBER_DECLTYPE_IMPL, (structName, _NAMEDPARAMS_UNPAREN pair))
+
+/// declares a key for each (key, member) pair inside an aggregate struct, so it can be 
+/// initialized with NamedParams::np_init. All members have to be listed in order.
+#define NAMEDPARAMS_AGGREGATE(structName, list) \
+  _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_GEN_MEMBER_KEY, (), (), structName, list) \
+  typedef NamedParams::KeyAggregate<structName, \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_MEMBER_DECLTYPE, (,), (), structName, list)> \
+    NamedParamsAggregate;
+
+#define _NAMEDPARAMS_ASSIGNED_KEY_TYPE(function, name, i, nele) \
+  NamedParams::AssignedKey<std::remove_const_t<decltype(name)>>
+
+#define _NAMEDPARAMS_ASSIGNED_KEY_RVALUE(function, name, i, nele) \
+  NamedParams::AssignedKey<std::remove_const_t<decltype(name)>>&&
+
+/// declares that calls to functionName with the named parameters in list (in that order) are
+/// instantiated in a single translation unit. Has to be used in the global namespace.
+#define NAMEDPARAMS_DECLARE_CALL(functionName, list) \
+  namespace NamedParams { \
+    template <> \
+    struct DeclaredCall<std::remove_const_t<decltype(functionName)>, \
+      _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_ASSIGNED_KEY_TYPE, (,), (), functionName, list)> \
+      : public std::true_type {}; \
+  } \
+  extern template decltype(functionName)::ResultType decltype(functionName)::callDeclared< \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_ASSIGNED_KEY_TYPE, (,), (), functionName, list)>( \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_ASSIGNED_KEY_RVALUE, (,), (), functionName, list)) const;
+
+/// instantiates a call declared with NAMEDPARAMS_DECLARE_CALL, has to be used in exactly one 
+/// translation unit in the global namespace.
+#define NAMEDPARAMS_INSTANTIATE_CALL(functionName, list) \
+  static_assert(std::remove_const_t<decltype(functionName)>::evalAnyError< \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_ASSIGNED_KEY_TYPE, (,), (), functionName, list)>(), \
+    "Invalid call signature in NAMEDPARAMS_INSTANTIATE_CALL"); \
+  template decltype(functionName)::ResultType decltype(functionName)::callDeclared< \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_ASSIGNED_KEY_TYPE, (,), (), functionName, list)>( \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_ASSIGNED_KEY_RVALUE, (,), (), functionName, list)) const;
+
+#define _NAMEDPARAMS_GEN_RESULT_KEY_IMPL(resultName, name, ...) \
+  NAMEDPARAMS_PARAM(name, __VA_ARGS__)
+
+#define _NAMEDPARAMS_GEN_RESULT_KEY(resultName, pair, i, nele) \
+  _NAMEDPARAMS_APPLY(_NAMEDPARAMS_GEN_RESULT_KEY_IMPL, (resultName, _NAMEDPARAMS_UNPAREN pair))
+
+#define _NAMEDPARAMS_RESULT_DECLTYPE_IMPL(resultName, name, ...) \
+  std::remove_const_t<decltype(name)>
+
+#define _NAMEDPARAMS_RESULT_DECLTYPE(resultName, pair, i, nele) \
+  _NAMEDPARAMS_APPLY(_NAMEDPARAMS_RESULT_DECLTYPE_IMPL, (resultName, _NAMEDPARAMS_UNPAREN pair))
+
+#define _NAMEDPARAMS_GEN_DATA_MEMBER_KEY_IMPL(className, name, member) \
+  enum _ENUM_##name {     \
+    _KEY_##name           \
+  };                      \
+  const inline static NamedParams::MemberKey<&className::member, \
+    NAMEDPARAMS_UNIQUE(name), _KEY_##name> name; 
+
+#define _NAMEDPARAMS_GEN_DATA_MEMBER_KEY(className, pair, i, nele) \
+  _NAMEDPARAMS_APPLY(_NAMEDPARAMS_GEN_DATA_MEMBER_KEY_IMPL, (className, _NAMEDPARAMS_UNPAREN pair))
+
+/// declares a MemberKey for each (key, member) pair of className, to be used with 
+/// NamedParams::np_update. Can be used inside or after the class, in any order.
+#define NAMEDPARAMS_MEMBER_KEYS(className, list) \
+  _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_GEN_DATA_MEMBER_KEY, (), (), className, list)
+
+/// declares a key for each (key, type) pair and resultName as the NamedResult of these keys
+#define NAMEDPARAMS_RESULT(resultName, list) \
+  _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_GEN_RESULT_KEY, (), (), resultName, list) \
+  typedef NamedParams::NamedResult< \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_RESULT_DECLTYPE, (,), (), resultName, list)> \
+    resultName;
+
+/// declares the keys of signature (a function type) and functionName, which calls the 
+/// generic callable with NamedParams::absent in place of omitted optionals
+#define NAMEDPARAMS_PARAMETRIZE_TEMPLATE(functionName, callable, signature, list) \
+  NAMEDPARAMS_DECLARE_KEYS(static_cast<signature*>(nullptr), list) \
+  const inline NamedParams::KeyTemplateFunction functionName(callable, \
+    static_cast<signature*>(nullptr), _NAMEDPARAMS_UNPAREN list);
+
+/// declares the keys of signature (a function type) and argsName as the NamedArgs of these keys,
+/// which is the parameter type of a function called through NAMEDPARAMS_PARAMETRIZE_ARGS
+#define NAMEDPARAMS_ARGS(argsName, signature, list) \
+  NAMEDPARAMS_DECLARE_KEYS(static_cast<signature*>(nullptr), list) \
+  typedef NamedParams::NamedArgs< \
+    _NAMEDPARAMS_ITERATE_LIST(_NAMEDPARAMS_DECLTYPE, (,), (), signature, list)> argsName;
+
+/// declares functionName, which calls function (taking a const argsName&) with the addresses of 
+/// the passed arguments
+#define NAMEDPARAMS_PARAMETRIZE_ARGS(functionName, function) \
+  constexpr inline NamedParams::KeyArgsFunction functionName( \
+    NamedParams::FunctionConstant<function>{});
 
 #define NAMEDPARAMS_PARAMETRIZE(functionName, function, list) \
   NAMEDPARAMS_DECLARE_KEYS(function, list) \
-  const inline NamedParams::KeyFunction functionName(function, _NAMEDPARAMS_UNPAREN list);
+  constexpr inline NamedParams::KeyFunction functionName( \
+    NamedParams::FunctionConstant<function>{}, _NAMEDPARAMS_UNPAREN list);
 
 #endif // NAMED_PARAMS_H
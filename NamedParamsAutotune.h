@@ -0,0 +1,363 @@
+#ifndef NAMED_PARAMS_AUTOTUNE_H
+#define NAMED_PARAMS_AUTOTUNE_H
+
+#include "NamedParams.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Autotuning of optional performance keys
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// FNV-1a hash of the key IDs of a KeyFunction
+template <class TKeyFunction>
+struct KeyFunctionIDHash;
+
+template <class TFunctionPtr, class... TFunctionKeys>
+struct KeyFunctionIDHash<KeyFunction<TFunctionPtr,TFunctionKeys...>>
+{
+  constexpr static uint64_t get()
+  {
+    uint64_t hash = FNV1A_OFFSET_BASIS;
+    for (int64_t id : {int64_t(TFunctionKeys::ID)...})
+    {
+      hash = fnv1a(hash, uint64_t(id));
+    }
+    return hash;
+  }
+};
+
+/// the key of a named parameter passed to a KeyFunction, void for positionals
+template <class T, bool = IsAssignedKey<typename std::decay<T>::type>::value>
+struct PassedKeyType
+{
+  typedef void type;
+};
+
+template <class T>
+struct PassedKeyType<T,true>
+{
+  typedef typename AssignedKeyType<typename std::decay<T>::type>::type type;
+};
+
+/// value of a tuned key, which is assigned to the key when the function is called
+template <class TKey>
+struct TunedValue
+{
+  typedef TKey keyType;
+
+  typename KeyValues<TKey>::ValueType value;
+};
+
+/// fastest configuration found for one input signature
+template <size_t NbTunedKeys>
+struct TunedConfiguration
+{
+  /// index of the chosen candidate of each tuned key
+  std::array<size_t,NbTunedKeys> indices;
+
+  /// fastest measured time of a single call
+  double nanoseconds;
+};
+
+/// Autotuner chooses the fastest candidate values of optional keys of a KeyFunction
+/// (e.g. batch or block sizes), separately for each input signature given by the user
+/// (e.g. a hash of the problem size). tune() times all combinations of the candidates, and
+/// stores the fastest one in a cache file. Calls through the Autotuner which omit the tuned
+/// keys pass the tuned values.
+/// Cache entries are identified by the name given to the tuner, the key IDs of the function, 
+/// the candidates and the input signature, so the cache file can be shared by several 
+/// functions if they are tuned under different names
+template <class TKeyFunction, class... TTunedKeys>
+class Autotuner
+{
+  public:
+
+    typedef typename TKeyFunction::ResultType ResultType;
+
+    typedef TunedConfiguration<sizeof...(TTunedKeys)> Configuration;
+
+    static_assert(sizeof...(TTunedKeys) > 0, "At least one key has to be tuned!");
+
+    static_assert(std::conjunction<IsOptional<typename KeyValues<TTunedKeys>::ValueType>...>::value,
+      "Only optional keys can be tuned!");
+
+    static_assert(std::conjunction<
+      std::is_trivially_copyable<typename KeyValues<TTunedKeys>::ValueType>...>::value,
+      "Only keys with trivially copyable values can be tuned!");
+
+    /// copies the candidates and reads the configurations for _name and them from 
+    /// _cacheFilename, if it exists
+    Autotuner(const char* _name, const TKeyFunction& _function, 
+      const std::string& _cacheFilename, const KeyValues<TTunedKeys>&... _candidates)
+      : m_function(_function)
+      , m_cacheFilename(_cacheFilename)
+      , m_candidates(std::vector<typename KeyValues<TTunedKeys>::ValueType>(
+          _candidates.begin(), _candidates.end())...)
+    {
+      // hashes the values, not the bytes of the optionals, which include padding and the
+      // storage of disengaged optionals
+      m_cacheID = fnv1a(getFunctionID(), _name);
+      std::apply([this](const auto&... _values)
+      {
+        ([this](const auto& _candidates)
+        {
+          m_cacheID = fnv1a(m_cacheID, uint64_t(_candidates.size()));
+          for (const auto& candidate : _candidates)
+          {
+            m_cacheID = fnv1a(m_cacheID, uint64_t(candidate.has_value()));
+            if (candidate)
+            {
+              m_cacheID = fnv1a(m_cacheID, &*candidate, sizeof(*candidate));
+            }
+          }
+        }(_values), ...);
+      }, m_candidates);
+
+      load();
+    }
+
+    /// times all combinations of the candidates _nbRepetitions times with the named
+    /// parameters _args, which must not contain the tuned keys. The fastest configuration
+    /// is used for _inputSignature from now on, and written to the cache file
+    template <class... Any>
+    Configuration tune(uint64_t _inputSignature, size_t _nbRepetitions, Any&&... _args)
+    {
+      std::array<size_t,sizeof...(TTunedKeys)> sizes = {};
+      size_t nbPoints = 1;
+      std::apply([&](const auto&... _values)
+      {
+        size_t i = 0;
+        ((sizes[i++] = _values.size()), ...);
+        ((nbPoints *= _values.size()), ...);
+      }, m_candidates);
+
+      Configuration best = {{}, std::numeric_limits<double>::infinity()};
+      auto arguments = std::forward_as_tuple(_args...);
+
+      for (size_t point = 0; point < nbPoints; ++point)
+      {
+        std::array<size_t,sizeof...(TTunedKeys)> indices = {};
+        for (size_t i = sizeof...(TTunedKeys), remaining = point; i-- > 0;)
+        {
+          indices[i] = remaining % sizes[i];
+          remaining /= sizes[i];
+        }
+
+        double fastest = std::numeric_limits<double>::infinity();
+        for (size_t repetition = 0; repetition < std::max(_nbRepetitions, size_t(1)); ++repetition)
+        {
+          auto start = std::chrono::steady_clock::now();
+          callWith(indices, arguments, std::make_index_sequence<sizeof...(Any)>{},
+            std::make_index_sequence<sizeof...(TTunedKeys)>{});
+          auto end = std::chrono::steady_clock::now();
+          fastest = std::min(fastest,
+            std::chrono::duration<double,std::nano>(end - start).count());
+        }
+
+        if (fastest < best.nanoseconds)
+        {
+          best = {indices, fastest};
+        }
+      }
+
+      {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_configurations[_inputSignature] = best;
+      }
+      save(_inputSignature, best);
+      return best;
+    }
+
+    /// calls the function, and passes the tuned values for _inputSignature for the tuned keys
+    /// which are not in _args. Without a tuned configuration, the function is called with _args
+    template <class... Any>
+    ResultType operator()(uint64_t _inputSignature, Any&&... _args) const
+    {
+      std::array<size_t,sizeof...(TTunedKeys)> indices;
+      {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto iter = m_configurations.find(_inputSignature);
+        if (iter == m_configurations.end())
+        {
+          lock.unlock();
+          return m_function(std::forward<Any>(_args)...);
+        }
+        indices = iter->second.indices;
+      }
+
+      return std::apply([&](const auto&... _tunedValues) -> ResultType
+      {
+        return m_function(std::forward<Any>(_args)...,
+          (typename std::decay<decltype(_tunedValues)>::type::keyType() = _tunedValues.value)...);
+      },
+      getTunedArguments<Any...>(indices, std::make_index_sequence<sizeof...(TTunedKeys)>{}));
+    }
+
+    /// returns the tuned configuration for _inputSignature, if there is one
+    std::optional<Configuration> getConfiguration(uint64_t _inputSignature) const
+    {
+      std::shared_lock<std::shared_mutex> lock(m_mutex);
+      auto iter = m_configurations.find(_inputSignature);
+      if (iter == m_configurations.end())
+      {
+        return std::nullopt;
+      }
+      return iter->second;
+    }
+
+  private:
+
+    const TKeyFunction& m_function;
+
+    std::string m_cacheFilename;
+
+    std::tuple<std::vector<typename KeyValues<TTunedKeys>::ValueType>...> m_candidates;
+
+    uint64_t m_cacheID;
+
+    mutable std::shared_mutex m_mutex;
+
+    std::unordered_map<uint64_t,Configuration> m_configurations;
+
+    /// hash of the key IDs of the function and the tuned keys
+    constexpr static uint64_t getFunctionID()
+    {
+      uint64_t hash = KeyFunctionIDHash<TKeyFunction>::get();
+      for (int64_t id : {int64_t(TTunedKeys::ID)...})
+      {
+        hash = fnv1a(hash, uint64_t(id));
+      }
+      return hash;
+    }
+
+    /// calls the function with the candidates _indices and the fixed named parameters
+    template <class TArguments, size_t... Is, size_t... Ts>
+    void callWith(const std::array<size_t,sizeof...(TTunedKeys)>& _indices,
+      TArguments& _arguments, std::index_sequence<Is...> const &,
+      std::index_sequence<Ts...> const &) const
+    {
+      m_function(FixedArgument<typename std::decay<
+          typename std::tuple_element<Is,TArguments>::type>::type>::get(
+          std::get<Is>(_arguments))...,
+        (TTunedKeys() = std::get<Ts>(m_candidates)[_indices[Ts]])...);
+    }
+
+    /// returns a tuple with the value of tuned key Idx, or an empty tuple if the key is in Any
+    template <size_t Idx, class... Any>
+    auto getTunedArgument(const std::array<size_t,sizeof...(TTunedKeys)>& _indices) const
+    {
+      typedef typename std::tuple_element<Idx,std::tuple<TTunedKeys...>>::type TunedKey;
+
+      if constexpr ((std::is_same<typename PassedKeyType<Any>::type, TunedKey>::value || ...))
+      {
+        return std::tuple<>();
+      }
+      else
+      {
+        return std::make_tuple(TunedValue<TunedKey>{std::get<Idx>(m_candidates)[_indices[Idx]]});
+      }
+    }
+
+    template <class... Any, size_t... Ts>
+    auto getTunedArguments(const std::array<size_t,sizeof...(TTunedKeys)>& _indices,
+      std::index_sequence<Ts...> const &) const
+    {
+      return std::tuple_cat(getTunedArgument<Ts,Any...>(_indices)...);
+    }
+
+    /// reads the configurations with the ID of this tuner from the cache file
+    void load()
+    {
+      std::ifstream file(m_cacheFilename);
+      std::string line;
+      while (std::getline(file, line))
+      {
+        std::istringstream stream(line);
+        uint64_t cacheID, inputSignature;
+        Configuration configuration;
+        stream >> std::hex >> cacheID >> inputSignature >> std::dec >> configuration.nanoseconds;
+        for (size_t& index : configuration.indices)
+        {
+          stream >> index;
+        }
+
+        if (stream && cacheID == m_cacheID && isValid(configuration))
+        {
+          m_configurations[inputSignature] = configuration;
+        }
+      }
+    }
+
+    /// checks that the indices of a configuration read from the cache are in range
+    bool isValid(const Configuration& _configuration) const
+    {
+      bool valid = true;
+      std::apply([&](const auto&... _values)
+      {
+        size_t i = 0;
+        ((valid = valid && _configuration.indices[i++] < _values.size()), ...);
+      }, m_candidates);
+      return valid;
+    }
+
+    /// replaces the entry for _inputSignature in the cache file
+    void save(uint64_t _inputSignature, const Configuration& _configuration) const
+    {
+      std::ostringstream entry;
+      entry << std::hex << m_cacheID << " " << _inputSignature << std::dec << " "
+        << _configuration.nanoseconds;
+      for (size_t index : _configuration.indices)
+      {
+        entry << " " << index;
+      }
+
+      std::ostringstream prefix;
+      prefix << std::hex << m_cacheID << " " << _inputSignature << " ";
+
+      std::vector<std::string> lines;
+      {
+        std::ifstream file(m_cacheFilename);
+        std::string line;
+        while (std::getline(file, line))
+        {
+          if (line.compare(0, prefix.str().size(), prefix.str()) != 0)
+          {
+            lines.push_back(line);
+          }
+        }
+      }
+      lines.push_back(entry.str());
+
+      std::ofstream file(m_cacheFilename, std::ios::trunc);
+      for (const std::string& line : lines)
+      {
+        file << line << "\n";
+      }
+      if (!file)
+      {
+        throw std::runtime_error("Could not write autotuning cache " + m_cacheFilename);
+      }
+    }
+};
+
+template <class TKeyFunction, class... TTunedKeys>
+Autotuner(const char* _name, const TKeyFunction& _function, const std::string& _cacheFilename,
+  const KeyValues<TTunedKeys>&... _candidates) -> Autotuner<TKeyFunction, TTunedKeys...>;
+
+} // end namespace NamedParams
+
+#endif // NAMED_PARAMS_AUTOTUNE_H
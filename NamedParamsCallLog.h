@@ -0,0 +1,582 @@
+#ifndef NAMED_PARAMS_CALL_LOG_H
+#define NAMED_PARAMS_CALL_LOG_H
+
+#include "NamedParams.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NAMEDPARAMS_CALL_LOG_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Recording and replaying calls of KeyFunctions
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// A call log is a binary file containing the calls of a single KeyFunction.
+/// It starts with a CallLogHeader, followed by the key ID and the value size of each function
+/// argument (in function order). Each call is stored as a 64 bit presence mask, followed by
+/// the raw bytes of the present arguments. Absent optionals take no space.
+struct CallLogHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t nbArguments;
+};
+
+constexpr char CALL_LOG_MAGIC[8] = {'N', 'P', 'C', 'A', 'L', 'L', 'L', 'G'};
+constexpr uint32_t CALL_LOG_VERSION = 1;
+
+/// type of the value stored in the log for a function argument of type T
+/// optionals and OptRef store their value type
+template <class T>
+struct _LoggedTypeImpl
+{
+  using type = T;
+};
+
+template <class T>
+struct _LoggedTypeImpl<std::optional<T>>
+{
+  using type = T;
+};
+
+template <class T>
+struct _LoggedTypeImpl<OptRef<T>>
+{
+  using type = typename std::remove_cv<T>::type;
+};
+
+template <class T>
+struct LoggedType
+{
+  using type = typename _LoggedTypeImpl<
+    typename std::remove_cv<typename std::remove_reference<T>::type>::type>::type;
+};
+
+/// returns a pointer to the value of a function argument, or nullptr if it is absent
+template <class T>
+inline const T* _getLoggedPointer(const T& _value)
+{
+  return &_value;
+}
+
+template <class T>
+inline const T* _getLoggedPointer(const std::optional<T>& _value)
+{
+  return _value ? &*_value : nullptr;
+}
+
+template <class T>
+inline const T* _getLoggedPointer(const OptRef<T>& _value)
+{
+  return _value.get();
+}
+
+inline const std::nullopt_t* _getLoggedPointer(const std::nullopt_t&)
+{
+  return nullptr;
+}
+
+/// storage for a single argument read from the log
+template <class T>
+struct LoggedValue
+{
+  alignas(T) unsigned char bytes[sizeof(T)];
+  bool present = false;
+
+  T& get()
+  {
+    return *reinterpret_cast<T*>(bytes);
+  }
+};
+
+/// describes the argument layout of a KeyFunction in a call log
+template <class TFunctionPtr, class... TFunctionKeys>
+struct CallLogSignature
+{
+  typedef FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type> KeyFunctionTraits;
+
+  static_assert(sizeof...(TFunctionKeys) <= 64, "Only functions with up to 64 arguments can be logged!");
+
+  static_assert(std::conjunction<std::bool_constant<
+      std::is_trivially_copyable<typename LoggedType<typename TFunctionKeys::type>::type>::value
+      && !std::is_pointer<typename LoggedType<typename TFunctionKeys::type>::type>::value
+    >...>::value,
+    "Only functions with trivially copyable, non-pointer arguments can be logged!");
+
+  constexpr inline static std::array<int64_t,sizeof...(TFunctionKeys)> keyIDs =
+  {
+    TFunctionKeys::ID...
+  };
+
+  constexpr inline static std::array<uint32_t,sizeof...(TFunctionKeys)> valueSizes =
+  {
+    sizeof(typename LoggedType<typename TFunctionKeys::type>::type)...
+  };
+
+  /// size of the header including key IDs and value sizes
+  constexpr inline static size_t headerSize = sizeof(CallLogHeader)
+    + sizeof...(TFunctionKeys) * (sizeof(int64_t) + sizeof(uint32_t));
+
+  /// maximum size of a single call in the log
+  constexpr inline static size_t maxRecordSize = sizeof(uint64_t)
+    + (sizeof(typename LoggedType<typename TFunctionKeys::type>::type) + ... + 0);
+
+  /// FNV-1a hash of the key IDs and value sizes
+  constexpr inline static uint64_t hashKeyIDs()
+  {
+    uint64_t hash = FNV1A_OFFSET_BASIS;
+    for (size_t i = 0; i < keyIDs.size(); ++i)
+    {
+      hash = fnv1a(fnv1a(hash, uint64_t(keyIDs[i])), uint64_t(valueSizes[i]));
+    }
+    return hash;
+  }
+
+  constexpr inline static uint64_t keyHash = hashKeyIDs();
+
+  /// identifies the function _name with this signature in other processes. 
+  /// Functions with the same keys are told apart by their name
+  constexpr inline static uint64_t getSignatureID(const char* _name)
+  {
+    return fnv1a(keyHash, _name);
+  }
+};
+
+/// serializes the reordered arguments of a single call into _record, which has to hold 
+/// CallLogSignature::maxRecordSize bytes. Returns the size of the record
+template <class... DArgs>
+inline size_t _serializeCall(char* _record, const DArgs&... _args)
+{
+  char* pos = _record + sizeof(uint64_t);
+  uint64_t mask = 0;
+  int i = 0;
+
+  ([&](const auto* _pValue)
+  {
+    if (_pValue)
+    {
+      mask |= (uint64_t(1) << i);
+      std::memcpy(pos, _pValue, sizeof(*_pValue));
+      pos += sizeof(*_pValue);
+    }
+    ++i;
+  }(_getLoggedPointer(_args)), ...);
+
+  std::memcpy(_record, &mask, sizeof(uint64_t));
+  return pos - _record;
+}
+
+/// returns the argument passed to the function for argument Idx
+template <class TFunctionTraits, size_t Idx, class TValue>
+inline decltype(auto) _getReplayArgument(LoggedValue<TValue>& _value)
+{
+  typedef typename TFunctionTraits::template arg<Idx>::type ArgType;
+  typedef typename std::remove_cv<typename std::remove_reference<ArgType>::type>::type
+    NoCVRefType;
+
+  if constexpr (IsOptional<NoCVRefType>::value)
+  {
+    return _value.present ? NoCVRefType(_value.get()) : NoCVRefType(std::nullopt);
+  }
+  else if constexpr (std::is_reference<ArgType>::value)
+  {
+    return static_cast<ArgType>(_value.get());
+  }
+  else
+  {
+    return NoCVRefType(_value.get());
+  }
+}
+
+/// reads a single record in [_pos, _end) and passes the arguments to _invoker. 
+/// Returns the position of the next record
+template <class TFunctionPtr, class... TFunctionKeys, class TInvoker, size_t... Is>
+inline const char* _decodeCall(const char* _pos, const char* _end, TInvoker&& _invoker, 
+  std::index_sequence<Is...> const &)
+{
+  typedef CallLogSignature<TFunctionPtr, TFunctionKeys...> Signature;
+
+  if (_end - _pos < (std::ptrdiff_t)sizeof(uint64_t))
+  {
+    throw std::runtime_error("Truncated call log!");
+  }
+
+  uint64_t mask;
+  std::memcpy(&mask, _pos, sizeof(uint64_t));
+  _pos += sizeof(uint64_t);
+
+  std::tuple<LoggedValue<typename LoggedType<typename TFunctionKeys::type>::type>...> values;
+
+  ([&](auto& _value, bool _isOptional)
+  {
+    _value.present = (mask >> Is) & 1;
+    if (!_value.present && !_isOptional)
+    {
+      throw std::runtime_error("Required argument missing in call log!");
+    }
+    if (_value.present)
+    {
+      if (_end - _pos < (std::ptrdiff_t)Signature::valueSizes[Is])
+      {
+        throw std::runtime_error("Truncated call log!");
+      }
+      std::memcpy(_value.bytes, _pos, Signature::valueSizes[Is]);
+      _pos += Signature::valueSizes[Is];
+    }
+  }(std::get<Is>(values), IsOptional<typename std::remove_cv<typename std::remove_reference<
+    typename TFunctionKeys::type>::type>::type>::value), ...);
+
+  _invoker(_getReplayArgument<typename Signature::KeyFunctionTraits, Is>(std::get<Is>(values))...);
+
+  return _pos;
+}
+
+/// CallRecorder calls a KeyFunction like its operator(), and appends the reordered arguments
+/// to a call log. Each thread appends its calls to its own buffer, which is written when it is 
+/// full, or on flush(). It can be used from several threads: the calls of one thread keep their
+/// order in the log, the calls of different threads are interleaved in chunks.
+template <class TFunctionPtr, class... TFunctionKeys>
+class CallRecorder
+{
+  private:
+
+    typedef KeyFunction<TFunctionPtr, TFunctionKeys...> BaseFunction;
+
+    typedef CallLogSignature<TFunctionPtr, TFunctionKeys...> Signature;
+
+    typedef typename BaseFunction::ResultType ResultType;
+
+    /// calls of a single thread, its mutex is only contended during flush()
+    struct ThreadBuffer
+    {
+      std::mutex mutex;
+      std::vector<char> data;
+      uint64_t nbCalls = 0;
+    };
+
+    /// buffer of a recorder in the calling thread, owner expires with the recorder
+    struct CachedBuffer
+    {
+      uint64_t recorderID;
+      ThreadBuffer* buffer;
+      std::weak_ptr<ThreadBuffer> owner;
+    };
+
+    const BaseFunction& m_function;
+
+    std::FILE* m_file;
+
+    size_t m_bufferSize;
+
+    /// identifies the recorder in the thread local buffer caches, never reused
+    const uint64_t m_recorderID;
+
+    /// protects m_file and m_threadBuffers
+    mutable std::mutex m_mutex;
+
+    std::vector<std::shared_ptr<ThreadBuffer>> m_threadBuffers;
+
+    static uint64_t nextRecorderID()
+    {
+      static std::atomic<uint64_t> recorderID(0);
+      return ++recorderID;
+    }
+
+    /// writes _data to the file, m_mutex has to be locked
+    void writeData(std::vector<char>& _data)
+    {
+      if (!_data.empty() && std::fwrite(_data.data(), 1, _data.size(), m_file) != _data.size())
+      {
+        throw std::runtime_error("Could not write call log!");
+      }
+      _data.clear();
+    }
+
+    /// returns the buffer of the calling thread, and creates it on its first call
+    ThreadBuffer& getThreadBuffer()
+    {
+      thread_local std::vector<CachedBuffer> cachedBuffers;
+
+      for (const CachedBuffer& cached : cachedBuffers)
+      {
+        if (cached.recorderID == m_recorderID)
+        {
+          return *cached.buffer;
+        }
+      }
+
+      // forget the buffers of destroyed recorders
+      cachedBuffers.erase(std::remove_if(cachedBuffers.begin(), cachedBuffers.end(),
+          [](const CachedBuffer& _cached) { return _cached.owner.expired(); }),
+        cachedBuffers.end());
+
+      std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+      buffer->data.reserve(m_bufferSize);
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threadBuffers.push_back(buffer);
+      }
+      cachedBuffers.push_back({m_recorderID, buffer.get(), buffer});
+      return *buffer;
+    }
+
+    /// serializes the reordered arguments of a single call
+    template <class... DArgs>
+    void record(const DArgs&... _args)
+    {
+      char record[Signature::maxRecordSize];
+      const size_t size = _serializeCall(record, _args...);
+
+      ThreadBuffer& buffer = getThreadBuffer();
+      std::unique_lock<std::mutex> bufferLock(buffer.mutex);
+      if (buffer.data.size() + size > m_bufferSize)
+      {
+        // the buffer lock is never held together with m_mutex, so flush() cannot deadlock
+        std::vector<char> chunk;
+        chunk.reserve(m_bufferSize);
+        chunk.swap(buffer.data);
+        bufferLock.unlock();
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          writeData(chunk);
+        }
+        bufferLock.lock();
+      }
+      buffer.data.insert(buffer.data.end(), record, record + size);
+      ++buffer.nbCalls;
+    }
+
+  public:
+
+    /// opens (and overwrites) the log file _filename for calls of _function
+    /// calls are written in chunks of up to _bufferSize bytes per thread
+    CallRecorder(const BaseFunction& _function, const std::string& _filename,
+      size_t _bufferSize = 1 << 20)
+      : m_function(_function)
+      , m_file(std::fopen(_filename.c_str(), "wb"))
+      , m_bufferSize(std::max(_bufferSize, Signature::maxRecordSize))
+      , m_recorderID(nextRecorderID())
+    {
+      if (!m_file)
+      {
+        throw std::runtime_error("Could not open call log " + _filename);
+      }
+
+      CallLogHeader header = {{}, CALL_LOG_VERSION, sizeof...(TFunctionKeys)};
+      std::memcpy(header.magic, CALL_LOG_MAGIC, sizeof(header.magic));
+
+      std::vector<char> headerData;
+      const char* pHeader = reinterpret_cast<const char*>(&header);
+      const char* pKeyIDs = reinterpret_cast<const char*>(Signature::keyIDs.data());
+      const char* pSizes = reinterpret_cast<const char*>(Signature::valueSizes.data());
+      headerData.insert(headerData.end(), pHeader, pHeader + sizeof(header));
+      headerData.insert(headerData.end(), pKeyIDs, pKeyIDs + sizeof(Signature::keyIDs));
+      headerData.insert(headerData.end(), pSizes, pSizes + sizeof(Signature::valueSizes));
+      try
+      {
+        writeData(headerData);
+      }
+      catch (...)
+      {
+        std::fclose(m_file);
+        throw;
+      }
+    }
+
+    CallRecorder(const CallRecorder&) = delete;
+
+    CallRecorder& operator=(const CallRecorder&) = delete;
+
+    ~CallRecorder()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const std::shared_ptr<ThreadBuffer>& buffer : m_threadBuffers)
+      {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (!buffer->data.empty())
+        {
+          std::fwrite(buffer->data.data(), 1, buffer->data.size(), m_file);
+        }
+      }
+      std::fclose(m_file);
+    }
+
+    /// records the call, then calls the function
+    template <class... Any, std::enable_if_t<BaseFunction::template evalAnyError<Any...>(), int> = 0>
+    ResultType operator()(Any&&... _args)
+    {
+      return m_function.apply(
+        [this](auto&&... _functionArgs) -> ResultType
+        {
+          record(_functionArgs...);
+          return m_function.call(std::forward<decltype(_functionArgs)>(_functionArgs)...);
+        },
+        std::forward<Any>(_args)...);
+    }
+
+    /// writes the buffered calls of all threads to the file
+    void flush()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const std::shared_ptr<ThreadBuffer>& buffer : m_threadBuffers)
+      {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        writeData(buffer->data);
+      }
+      std::fflush(m_file);
+    }
+
+    uint64_t getNbCalls() const
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      uint64_t nbCalls = 0;
+      for (const std::shared_ptr<ThreadBuffer>& buffer : m_threadBuffers)
+      {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        nbCalls += buffer->nbCalls;
+      }
+      return nbCalls;
+    }
+
+};
+
+/// CallLogReader maps a call log written by CallRecorder into memory, and replays its calls
+class CallLogReader
+{
+  private:
+
+    const char* m_data;
+
+    size_t m_size;
+
+#ifdef NAMEDPARAMS_CALL_LOG_MMAP
+    void* m_mapping;
+#else
+    std::vector<char> m_content;
+#endif
+
+  public:
+
+    /// maps the log file _filename into memory
+    explicit CallLogReader(const std::string& _filename)
+    {
+#ifdef NAMEDPARAMS_CALL_LOG_MMAP
+      int fd = ::open(_filename.c_str(), O_RDONLY);
+      struct stat status;
+      if (fd < 0 || ::fstat(fd, &status) != 0)
+      {
+        if (fd >= 0)
+        {
+          ::close(fd);
+        }
+        throw std::runtime_error("Could not open call log " + _filename);
+      }
+
+      m_size = status.st_size;
+      m_mapping = (m_size > 0) ? ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+      ::close(fd);
+
+      if (m_mapping == MAP_FAILED)
+      {
+        throw std::runtime_error("Could not map call log " + _filename);
+      }
+      m_data = static_cast<const char*>(m_mapping);
+#else
+      std::ifstream file(_filename, std::ios::binary);
+      if (!file)
+      {
+        throw std::runtime_error("Could not open call log " + _filename);
+      }
+      m_content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      m_data = m_content.data();
+      m_size = m_content.size();
+#endif
+    }
+
+    CallLogReader(const CallLogReader&) = delete;
+
+    CallLogReader& operator=(const CallLogReader&) = delete;
+
+    ~CallLogReader()
+    {
+#ifdef NAMEDPARAMS_CALL_LOG_MMAP
+      if (m_mapping)
+      {
+        ::munmap(m_mapping, m_size);
+      }
+#endif
+    }
+
+    /// size of the log in bytes
+    size_t getSize() const
+    {
+      return m_size;
+    }
+
+    /// calls _function with the arguments of all calls in the log, returns the number of calls.
+    /// Throws if the log was not recorded for a function with the same keys and argument types
+    template <class TFunctionPtr, class... TFunctionKeys>
+    uint64_t replay(const KeyFunction<TFunctionPtr,TFunctionKeys...>& _function) const
+    {
+      typedef CallLogSignature<TFunctionPtr, TFunctionKeys...> Signature;
+
+      CallLogHeader header;
+      if (m_size < Signature::headerSize)
+      {
+        throw std::runtime_error("Call log does not match the function!");
+      }
+      std::memcpy(&header, m_data, sizeof(header));
+
+      std::array<int64_t,sizeof...(TFunctionKeys)> keyIDs;
+      std::array<uint32_t,sizeof...(TFunctionKeys)> valueSizes;
+      std::memcpy(keyIDs.data(), m_data + sizeof(header), sizeof(keyIDs));
+      std::memcpy(valueSizes.data(), m_data + sizeof(header) + sizeof(keyIDs), sizeof(valueSizes));
+
+      if (std::memcmp(header.magic, CALL_LOG_MAGIC, sizeof(header.magic)) != 0
+        || header.version != CALL_LOG_VERSION || header.nbArguments != sizeof...(TFunctionKeys)
+        || keyIDs != Signature::keyIDs || valueSizes != Signature::valueSizes)
+      {
+        throw std::runtime_error("Call log does not match the function!");
+      }
+
+      uint64_t nbCalls = 0;
+      const char* pos = m_data + Signature::headerSize;
+      while (pos != m_data + m_size)
+      {
+        pos = _decodeCall<TFunctionPtr, TFunctionKeys...>(pos, m_data + m_size, 
+          [&_function](auto&&... _args)
+          {
+            _function.call(std::forward<decltype(_args)>(_args)...);
+          }, 
+          std::make_index_sequence<sizeof...(TFunctionKeys)>{});
+        ++nbCalls;
+      }
+
+      return nbCalls;
+    }
+
+};
+
+} // end namespace NamedParams
+
+#endif // NAMED_PARAMS_CALL_LOG_H
@@ -0,0 +1,313 @@
+#ifndef NAMED_PARAMS_COLUMNS_H
+#define NAMED_PARAMS_COLUMNS_H
+
+#include "NamedParams.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Key-indexed structure of arrays
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// contiguous array of T which starts at a multiple of TAlignment bytes
+template <class T, size_t TAlignment = 64>
+class AlignedColumn
+{
+  public:
+
+    static_assert(TAlignment >= alignof(T) && (TAlignment & (TAlignment - 1)) == 0,
+      "Column alignment has to be a power of two, and at least the alignment of T!");
+
+    AlignedColumn()
+      : m_data(nullptr)
+      , m_size(0)
+      , m_capacity(0)
+    {
+    }
+
+    AlignedColumn(const AlignedColumn& _other)
+      : AlignedColumn()
+    {
+      reserve(_other.m_size);
+      for (const T& value : _other)
+      {
+        pushBack(value);
+      }
+    }
+
+    AlignedColumn(AlignedColumn&& _other) noexcept
+      : m_data(std::exchange(_other.m_data, nullptr))
+      , m_size(std::exchange(_other.m_size, 0))
+      , m_capacity(std::exchange(_other.m_capacity, 0))
+    {
+    }
+
+    AlignedColumn& operator=(AlignedColumn _other) noexcept
+    {
+      std::swap(m_data, _other.m_data);
+      std::swap(m_size, _other.m_size);
+      std::swap(m_capacity, _other.m_capacity);
+      return *this;
+    }
+
+    ~AlignedColumn()
+    {
+      clear();
+      ::operator delete(m_data, std::align_val_t(TAlignment));
+    }
+
+    /// moves the values to new storage for at least _capacity values
+    void reserve(size_t _capacity)
+    {
+      if (_capacity <= m_capacity)
+      {
+        return;
+      }
+
+      T* data = static_cast<T*>(::operator new(_capacity * sizeof(T), std::align_val_t(TAlignment)));
+      for (size_t i = 0; i < m_size; ++i)
+      {
+        new (data + i) T(std::move_if_noexcept(m_data[i]));
+        m_data[i].~T();
+      }
+      ::operator delete(m_data, std::align_val_t(TAlignment));
+
+      m_data = data;
+      m_capacity = _capacity;
+    }
+
+    template <class D>
+    void pushBack(D&& _value)
+    {
+      if (m_size == m_capacity)
+      {
+        reserve(std::max(size_t(16), 2 * m_capacity));
+      }
+      new (m_data + m_size) T(std::forward<D>(_value));
+      ++m_size;
+    }
+
+    /// appends or removes values at the end, new values are default constructed
+    void resize(size_t _size)
+    {
+      reserve(_size);
+      for (; m_size < _size; ++m_size)
+      {
+        new (m_data + m_size) T();
+      }
+      for (; m_size > _size; --m_size)
+      {
+        m_data[m_size - 1].~T();
+      }
+    }
+
+    void clear()
+    {
+      resize(0);
+    }
+
+    size_t size() const
+    {
+      return m_size;
+    }
+
+    T* data()
+    {
+      return m_data;
+    }
+
+    const T* data() const
+    {
+      return m_data;
+    }
+
+    T& operator[](size_t _idx)
+    {
+      return m_data[_idx];
+    }
+
+    const T& operator[](size_t _idx) const
+    {
+      return m_data[_idx];
+    }
+
+    T* begin()
+    {
+      return m_data;
+    }
+
+    T* end()
+    {
+      return m_data + m_size;
+    }
+
+    const T* begin() const
+    {
+      return m_data;
+    }
+
+    const T* end() const
+    {
+      return m_data + m_size;
+    }
+
+  private:
+
+    T* m_data;
+
+    size_t m_size;
+
+    size_t m_capacity;
+};
+
+/// NamedColumns stores a table with one aligned, contiguous column per key (structure of
+/// arrays). Columns are accessed by key (columns[kScaling]), rows are appended with the same
+/// syntax as a call, and apply() calls a KeyFunction row by row.
+/// Columns store the value type of the key, e.g. std::optional<double> for optional keys
+/// and Basis for keys of type const Basis&.
+template <class... TColumnKeys>
+class NamedColumns
+{
+  public:
+
+    /// value type stored for TKey
+    template <class TKey>
+    using ValueType = typename std::remove_cv<
+      typename std::remove_reference<typename TKey::type>::type>::type;
+
+    typedef std::tuple<ValueType<TColumnKeys>...> RowType;
+
+  private:
+
+    std::tuple<AlignedColumn<ValueType<TColumnKeys>>...> m_columns;
+
+    /// returns the position of TKey in TColumnKeys, or sizeof...(TColumnKeys) if it is not
+    /// a column
+    template <class TKey>
+    constexpr inline static size_t getIndex()
+    {
+      return getKeyIndex<TKey, TColumnKeys...>();
+    }
+
+    /// positions of the columns which are passed to a function with the keys TFunctionKeys,
+    /// in the order of the function keys
+    template <class... TFunctionKeys>
+    using ColumnSelection = SelectedIndices<sizeof...(TColumnKeys), 
+      getIndex<TFunctionKeys>()...>;
+
+    /// calls _function for row _row, with the selected columns followed by the fixed arguments
+    template <class TKeyFunction, class TArguments, size_t... Cs, size_t... Is>
+    NAMEDPARAMS_FORCE_INLINE decltype(auto) callRow(const TKeyFunction& _function, size_t _row,
+      TArguments& _arguments, std::index_sequence<Cs...> const &,
+      std::index_sequence<Is...> const &) const
+    {
+      return _function(
+        (typename std::remove_cv<typename std::tuple_element<Cs,
+          std::tuple<TColumnKeys...>>::type>::type() = std::get<Cs>(m_columns)[_row])...,
+        FixedArgument<typename std::decay<typename std::tuple_element<Is,TArguments>::type>::type>
+          ::get(std::get<Is>(_arguments))...);
+    }
+
+    template <size_t... Cs>
+    void pushBackRow(RowType& _row, std::index_sequence<Cs...> const &)
+    {
+      (std::get<Cs>(m_columns).pushBack(std::move(std::get<Cs>(_row))), ...);
+    }
+
+  public:
+
+    NamedColumns() = default;
+
+    /// table with _nbRows default constructed rows
+    explicit NamedColumns(size_t _nbRows)
+    {
+      resize(_nbRows);
+    }
+
+    size_t size() const
+    {
+      return std::get<0>(m_columns).size();
+    }
+
+    void reserve(size_t _nbRows)
+    {
+      std::apply([_nbRows](auto&... _columns) { (_columns.reserve(_nbRows), ...); }, m_columns);
+    }
+
+    void resize(size_t _nbRows)
+    {
+      std::apply([_nbRows](auto&... _columns) { (_columns.resize(_nbRows), ...); }, m_columns);
+    }
+
+    /// appends a row, initialized with positionals, named parameters and optionals in the
+    /// order of the column keys. Absent optionals are std::nullopt
+    /// fails at compile time if passed arguments are invalid
+    template <class... Any>
+    void pushBack(Any&&... _args)
+    {
+      RowType row = KeyAggregate<RowType,typename std::remove_cv<TColumnKeys>::type...>::init(
+        std::forward<Any>(_args)...);
+
+      pushBackRow(row, std::index_sequence_for<TColumnKeys...>{});
+    }
+
+    /// returns the column of _key
+    template <class TKey, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    auto& operator[]([[maybe_unused]] const TKey& _key)
+    {
+      static_assert(getIndex<TKey>() < sizeof...(TColumnKeys), "Key is not a column!");
+      return std::get<getIndex<TKey>()>(m_columns);
+    }
+
+    template <class TKey, std::enable_if_t<IsKey<TKey>::value, int> = 0>
+    const auto& operator[]([[maybe_unused]] const TKey& _key) const
+    {
+      static_assert(getIndex<TKey>() < sizeof...(TColumnKeys), "Key is not a column!");
+      return std::get<getIndex<TKey>()>(m_columns);
+    }
+
+    /// calls _function for each row in order. The columns of the keys of _function are passed
+    /// as named parameters, columns the function does not take are skipped. _args are
+    /// named parameters for the keys which are not columns, and are passed to every row.
+    /// Returns the results in a std::vector, unless the function returns void
+    template <class TFunctionPtr, class... TFunctionKeys, class... Any>
+    auto apply(const KeyFunction<TFunctionPtr,TFunctionKeys...>& _function, Any&&... _args) const
+    {
+      typedef typename KeyFunction<TFunctionPtr,TFunctionKeys...>::ResultType ResultType;
+      typedef typename ColumnSelection<TFunctionKeys...>::Sequence Columns;
+
+      auto arguments = std::forward_as_tuple(_args...);
+      const size_t nbRows = size();
+
+      if constexpr (std::is_void<ResultType>::value)
+      {
+        for (size_t row = 0; row < nbRows; ++row)
+        {
+          callRow(_function, row, arguments, Columns{},
+            std::make_index_sequence<sizeof...(Any)>{});
+        }
+      }
+      else
+      {
+        std::vector<ResultType> results;
+        results.reserve(nbRows);
+        for (size_t row = 0; row < nbRows; ++row)
+        {
+          results.push_back(callRow(_function, row, arguments, Columns{},
+            std::make_index_sequence<sizeof...(Any)>{}));
+        }
+        return results;
+      }
+    }
+
+};
+
+} // end namespace NamedParams
+
+#endif // NAMED_PARAMS_COLUMNS_H
@@ -0,0 +1,216 @@
+#ifndef NAMED_PARAMS_COROUTINE_H
+#define NAMED_PARAMS_COROUTINE_H
+
+#include "NamedParams.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <utility>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Minimal coroutine task and executor
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// lazily started coroutine which returns a value of type T (not void).
+/// A Task can be awaited by another coroutine, or started with Executor::spawn.
+/// KeyFunctions of coroutines move by-value arguments into the coroutine frame, and do not
+/// compile if a temporary is bound to a reference parameter
+template <class T>
+class Task
+{
+  public:
+
+    struct promise_type;
+
+    typedef std::coroutine_handle<promise_type> HandleType;
+
+    /// resumes the awaiting coroutine, if any, when the task is finished
+    struct FinalAwaiter
+    {
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      std::coroutine_handle<> await_suspend(HandleType _handle) noexcept
+      {
+        std::coroutine_handle<> continuation = _handle.promise().m_continuation;
+        return (continuation) ? continuation : std::noop_coroutine();
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+    };
+
+    struct promise_type
+    {
+      std::optional<T> m_value;
+      std::exception_ptr m_exception;
+      std::coroutine_handle<> m_continuation;
+
+      Task get_return_object()
+      {
+        return Task(HandleType::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      FinalAwaiter final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      template <class D>
+      void return_value(D&& _value)
+      {
+        m_value.emplace(std::forward<D>(_value));
+      }
+
+      void unhandled_exception()
+      {
+        m_exception = std::current_exception();
+      }
+    };
+
+    Task(const Task& _other) = delete;
+
+    Task(Task&& _other) noexcept
+      : m_handle(std::exchange(_other.m_handle, nullptr))
+    {
+    }
+
+    Task& operator=(const Task& _other) = delete;
+
+    Task& operator=(Task&& _other) noexcept
+    {
+      std::swap(m_handle, _other.m_handle);
+      return *this;
+    }
+
+    ~Task()
+    {
+      if (m_handle)
+      {
+        m_handle.destroy();
+      }
+    }
+
+    bool isDone() const
+    {
+      return m_handle && m_handle.done();
+    }
+
+    /// returns the result of a finished task, or rethrows its exception
+    T& getResult()
+    {
+      promise_type& promise = m_handle.promise();
+      if (promise.m_exception)
+      {
+        std::rethrow_exception(promise.m_exception);
+      }
+      return *promise.m_value;
+    }
+
+    std::coroutine_handle<> getHandle() const
+    {
+      return m_handle;
+    }
+
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    /// starts the task, which resumes _awaiting when it is finished
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> _awaiting) noexcept
+    {
+      m_handle.promise().m_continuation = _awaiting;
+      return m_handle;
+    }
+
+    T await_resume()
+    {
+      return std::move(getResult());
+    }
+
+  private:
+
+    explicit Task(HandleType _handle)
+      : m_handle(_handle)
+    {
+    }
+
+    HandleType m_handle;
+};
+
+/// single-threaded executor which resumes queued coroutines in FIFO order
+class Executor
+{
+  public:
+
+    /// suspends the awaiting coroutine and queues it
+    struct ScheduleAwaiter
+    {
+      Executor* m_executor;
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      void await_suspend(std::coroutine_handle<> _handle)
+      {
+        m_executor->m_queue.push_back(_handle);
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+    };
+
+    ScheduleAwaiter schedule()
+    {
+      return ScheduleAwaiter{this};
+    }
+
+    /// queues a task which has not been started yet
+    template <class T>
+    void spawn(const Task<T>& _task)
+    {
+      m_queue.push_back(_task.getHandle());
+    }
+
+    /// resumes queued coroutines until the queue is empty, returns the number of resumptions
+    size_t run()
+    {
+      size_t nbResumed = 0;
+      while (!m_queue.empty())
+      {
+        std::coroutine_handle<> handle = m_queue.front();
+        m_queue.pop_front();
+        handle.resume();
+        ++nbResumed;
+      }
+      return nbResumed;
+    }
+
+  private:
+
+    std::deque<std::coroutine_handle<>> m_queue;
+};
+
+} // end namespace NamedParams
+
+#endif // __cpp_impl_coroutine
+
+#endif // NAMED_PARAMS_COROUTINE_H
@@ -0,0 +1,553 @@
+#ifndef NAMED_PARAMS_GRAPH_H
+#define NAMED_PARAMS_GRAPH_H
+
+#include "NamedParams.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Dataflow graphs of KeyFunctions
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// a node of a TaskGraph: the result of the function is the value of TOutputKey, which is
+/// passed to all nodes taking TOutputKey
+template <class TOutputKey, class TKeyFunction>
+class GraphNode;
+
+template <class TOutputKey, class TFunctionPtr, class... TFunctionKeys>
+class GraphNode<TOutputKey,KeyFunction<TFunctionPtr,TFunctionKeys...>>
+{
+  public:
+
+    typedef typename std::remove_cv<TOutputKey>::type OutputKey;
+
+    /// type in which the output is stored
+    typedef typename std::remove_cv<
+      typename std::remove_reference<typename OutputKey::type>::type>::type OutputType;
+
+    typedef KeyFunction<TFunctionPtr,TFunctionKeys...> FunctionType;
+
+    typedef std::tuple<typename std::remove_cv<TFunctionKeys>::type...> InputKeys;
+
+    constexpr static size_t nbInputs = sizeof...(TFunctionKeys);
+
+    static_assert(std::is_convertible<typename FunctionType::ResultType,OutputType>::value,
+      "The result of the function cannot be converted to the type of the output key!");
+
+    explicit constexpr GraphNode(const FunctionType& _function)
+      : m_function(_function)
+    {
+    }
+
+    /// key IDs of the inputs, followed by -1
+    constexpr static std::array<int64_t,nbInputs + 1> getInputIDs()
+    {
+      return { TFunctionKeys::ID..., -1 };
+    }
+
+    constexpr static std::array<bool,nbInputs + 1> getInputIsOptional()
+    {
+      return { IsOptional<typename std::remove_cv<
+        typename std::remove_reference<typename TFunctionKeys::type>::type>::type>::value..., false };
+    }
+
+    const FunctionType& getFunction() const
+    {
+      return m_function;
+    }
+
+  private:
+
+    FunctionType m_function;
+};
+
+/// node which assigns the result of _function to _outputKey, e.g. node(kBasis, np_buildBasis)
+template <class TOutputKey, class TKeyFunction>
+constexpr GraphNode<TOutputKey,TKeyFunction> node([[maybe_unused]] const TOutputKey& _outputKey,
+  const TKeyFunction& _function)
+{
+  return GraphNode<TOutputKey,TKeyFunction>(_function);
+}
+
+/// outputs of a TaskGraph run, accessed with the output keys. Outputs which were moved into
+/// their only consumer are empty
+template <class... TOutputKeys>
+class TaskGraphResult
+{
+  public:
+
+    template <class TKey>
+    using ValueType = typename std::remove_cv<
+      typename std::remove_reference<typename TKey::type>::type>::type;
+
+    template <class TKey>
+    std::optional<ValueType<TKey>>& operator[]([[maybe_unused]] const TKey& _key)
+    {
+      static_assert(getIndex<TKey>() < sizeof...(TOutputKeys), "Key is not an output!");
+      return std::get<getIndex<TKey>()>(m_values);
+    }
+
+    template <class TKey>
+    const std::optional<ValueType<TKey>>& operator[]([[maybe_unused]] const TKey& _key) const
+    {
+      static_assert(getIndex<TKey>() < sizeof...(TOutputKeys), "Key is not an output!");
+      return std::get<getIndex<TKey>()>(m_values);
+    }
+
+    /// output of node Idx
+    template <size_t Idx>
+    auto& get()
+    {
+      return std::get<Idx>(m_values);
+    }
+
+  private:
+
+    std::tuple<std::optional<ValueType<TOutputKeys>>...> m_values;
+
+    template <class TKey>
+    constexpr inline static size_t getIndex()
+    {
+      return getKeyIndex<TKey, TOutputKeys...>();
+    }
+};
+
+/// TaskGraph runs a directed acyclic graph of KeyFunctions, in which the output key of a node
+/// is passed to all nodes which take that key. Keys which are not the output of a node are
+/// passed to run(). Independent nodes run in parallel.
+/// The wiring is checked at compile time: duplicate outputs, cycles, output types which do not
+/// convert to the inputs of their consumers, and required keys which are neither an output nor
+/// passed to run() do not compile. Omitted optional keys are absent.
+/// Intermediates are passed without copies to reference keys, and moved into a by-value key if
+/// it is their only consumer. By-value keys with several consumers get a copy each
+template <class... TNodes>
+class TaskGraph
+{
+  public:
+
+    constexpr static size_t nbNodes = sizeof...(TNodes);
+
+    typedef TaskGraphResult<typename TNodes::OutputKey...> ResultType;
+
+    static_assert(nbNodes > 0, "A TaskGraph needs at least one node!");
+
+    explicit constexpr TaskGraph(const TNodes&... _nodes)
+      : m_nodes(_nodes...)
+    {
+    }
+
+    /// runs all nodes on _nbThreads threads, including the calling thread. _args are the named
+    /// parameters for inputs which are not outputs of a node.
+    /// The first exception of a node is rethrown after the running nodes have finished, nodes
+    /// which did not start yet are skipped
+    template <class... Any>
+    ResultType run(size_t _nbThreads, Any&&... _args) const
+    {
+      static_assert(std::conjunction<IsAssignedKey<typename std::decay<Any>::type>...>::value,
+        "Only named parameters can be passed to a TaskGraph!");
+      static_assert(checkPassedKeys<typename std::decay<Any>::type...>(),
+        "A key passed to run is the output of a node, or not an input of any node!");
+
+      typedef std::tuple<Any&&...> Inputs;
+      Inputs inputs(std::forward<Any>(_args)...);
+      ResultType outputs;
+
+      constexpr auto runners = getRunners<Inputs>(std::make_index_sequence<nbNodes>{});
+      constexpr auto dependencies = getDependencies();
+
+      std::array<size_t,nbNodes> remaining = {};
+      std::vector<size_t> ready;
+      for (size_t i = 0; i < nbNodes; ++i)
+      {
+        for (size_t j = 0; j < nbNodes; ++j)
+        {
+          remaining[i] += dependencies[i][j] ? 1 : 0;
+        }
+        if (remaining[i] == 0)
+        {
+          ready.push_back(i);
+        }
+      }
+
+      std::mutex mutex;
+      std::condition_variable condition;
+      size_t nbDone = 0;
+      bool stopped = false;
+      std::exception_ptr error;
+
+      auto work = [&]()
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+          condition.wait(lock, [&]() { return !ready.empty() || nbDone == nbNodes || stopped; });
+          if (stopped || ready.empty())
+          {
+            break;
+          }
+
+          const size_t node = ready.back();
+          ready.pop_back();
+          lock.unlock();
+
+          try
+          {
+            (this->*runners[node])(outputs, inputs);
+          }
+          catch (...)
+          {
+            lock.lock();
+            if (!error)
+            {
+              error = std::current_exception();
+            }
+            stopped = true;
+            condition.notify_all();
+            continue;
+          }
+
+          lock.lock();
+          ++nbDone;
+          for (size_t i = 0; i < nbNodes; ++i)
+          {
+            if (dependencies[i][node] && --remaining[i] == 0)
+            {
+              ready.push_back(i);
+            }
+          }
+          condition.notify_all();
+        }
+      };
+
+      const size_t nbWorkers = std::max(std::min(_nbThreads, nbNodes), size_t(1));
+      std::vector<std::thread> threads;
+      threads.reserve(nbWorkers - 1);
+      for (size_t i = 1; i < nbWorkers; ++i)
+      {
+        threads.emplace_back(work);
+      }
+      work();
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+      return outputs;
+    }
+
+    /// run on all hardware threads
+    template <class... Any, std::enable_if_t<
+      std::conjunction<IsAssignedKey<typename std::decay<Any>::type>...>::value, int> = 0>
+    ResultType run(Any&&... _args) const
+    {
+      return run(size_t(std::thread::hardware_concurrency()), std::forward<Any>(_args)...);
+    }
+
+  private:
+
+    std::tuple<TNodes...> m_nodes;
+
+    constexpr static std::array<int64_t,nbNodes> s_outputIDs = { TNodes::OutputKey::ID... };
+
+    /// index of the node with output _id, nbNodes if there is none
+    constexpr static size_t findProducer(int64_t _id)
+    {
+      for (size_t i = 0; i < nbNodes; ++i)
+      {
+        if (s_outputIDs[i] == _id)
+        {
+          return i;
+        }
+      }
+      return nbNodes;
+    }
+
+    /// sets row _row of _dependencies for a node with the inputs _inputIDs (terminated by -1)
+    template <size_t N>
+    constexpr static void setDependencies(std::array<bool,nbNodes>& _row,
+      const std::array<int64_t,N>& _inputIDs)
+    {
+      for (size_t i = 0; i + 1 < N; ++i)
+      {
+        const size_t producer = findProducer(_inputIDs[i]);
+        if (producer < nbNodes)
+        {
+          _row[producer] = true;
+        }
+      }
+    }
+
+    /// element [i][j] is true if node i takes the output of node j
+    constexpr static std::array<std::array<bool,nbNodes>,nbNodes> getDependencies()
+    {
+      std::array<std::array<bool,nbNodes>,nbNodes> dependencies = {};
+      size_t i = 0;
+      ((setDependencies(dependencies[i++], TNodes::getInputIDs())), ...);
+      return dependencies;
+    }
+
+    constexpr static bool hasUniqueOutputs()
+    {
+      for (size_t i = 0; i < nbNodes; ++i)
+      {
+        for (size_t j = i + 1; j < nbNodes; ++j)
+        {
+          if (s_outputIDs[i] == s_outputIDs[j])
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    /// removes nodes without remaining dependencies until none is left (Kahn's algorithm)
+    constexpr static bool isAcyclic()
+    {
+      constexpr auto dependencies = getDependencies();
+      std::array<bool,nbNodes> removed = {};
+      for (size_t nbRemoved = 0; nbRemoved < nbNodes; ++nbRemoved)
+      {
+        size_t next = nbNodes;
+        for (size_t i = 0; i < nbNodes && next == nbNodes; ++i)
+        {
+          bool isReady = !removed[i];
+          for (size_t j = 0; j < nbNodes; ++j)
+          {
+            isReady = isReady && (removed[j] || !dependencies[i][j]);
+          }
+          next = isReady ? i : next;
+        }
+        if (next == nbNodes)
+        {
+          return false;
+        }
+        removed[next] = true;
+      }
+      return true;
+    }
+
+    static_assert(hasUniqueOutputs(), "Two nodes of a TaskGraph have the same output key!");
+
+    static_assert(isAcyclic(), "The nodes of a TaskGraph form a cycle!");
+
+    /// number of nodes which take the output of node _producer
+    constexpr static size_t getNbConsumers(size_t _producer)
+    {
+      constexpr auto dependencies = getDependencies();
+      size_t nb = 0;
+      for (size_t i = 0; i < nbNodes; ++i)
+      {
+        nb += dependencies[i][_producer] ? 1 : 0;
+      }
+      return nb;
+    }
+
+    /// index of the argument of run with key _id, or the number of arguments
+    template <class TInputs>
+    constexpr static size_t findPassed(int64_t _id)
+    {
+      constexpr std::array<int64_t,std::tuple_size<TInputs>::value + 1> passedIDs =
+        getPassedIDs<TInputs>(std::make_index_sequence<std::tuple_size<TInputs>::value>{});
+      for (size_t i = 0; i < std::tuple_size<TInputs>::value; ++i)
+      {
+        if (passedIDs[i] == _id)
+        {
+          return i;
+        }
+      }
+      return std::tuple_size<TInputs>::value;
+    }
+
+    template <class TInputs, size_t... Is>
+    constexpr static std::array<int64_t,sizeof...(Is) + 1> getPassedIDs(
+      std::index_sequence<Is...> const &)
+    {
+      return { AssignedKeyType<typename std::decay<
+        typename std::tuple_element<Is,TInputs>::type>::type>::type::ID..., -1 };
+    }
+
+    /// keys passed to run have to be inputs of a node, and must not be outputs
+    template <class... Passed>
+    constexpr static bool checkPassedKeys()
+    {
+      constexpr std::array<int64_t,sizeof...(Passed) + 1> passedIDs =
+      {
+        AssignedKeyType<Passed>::type::ID..., -1
+      };
+      constexpr std::array<bool,sizeof...(Passed) + 1> isUsed =
+      {
+        isInput(AssignedKeyType<Passed>::type::ID)..., true
+      };
+      for (size_t i = 0; i < sizeof...(Passed); ++i)
+      {
+        if (findProducer(passedIDs[i]) < nbNodes || !isUsed[i])
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    constexpr static bool isInput(int64_t _id)
+    {
+      bool found = false;
+      ((found = found || hasKey(TNodes::getInputIDs(), _id)), ...);
+      return found;
+    }
+
+    template <size_t N>
+    constexpr static bool hasKey(const std::array<int64_t,N>& _ids, int64_t _id)
+    {
+      for (size_t i = 0; i + 1 < N; ++i)
+      {
+        if (_ids[i] == _id)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// inputs of node NodeIdx which are available with the arguments TInputs of run
+    template <size_t NodeIdx, class TInputs>
+    struct NodeArguments
+    {
+      typedef typename std::tuple_element<NodeIdx,std::tuple<TNodes...>>::type Node;
+
+      constexpr static size_t nbInputs = Node::nbInputs;
+
+      constexpr static std::array<bool,nbInputs + 1> getIsAvailable()
+      {
+        constexpr std::array<int64_t,nbInputs + 1> inputIDs = Node::getInputIDs();
+        std::array<bool,nbInputs + 1> isAvailable = {};
+        for (size_t i = 0; i < nbInputs; ++i)
+        {
+          isAvailable[i] = findProducer(inputIDs[i]) < nbNodes
+            || findPassed<TInputs>(inputIDs[i]) < std::tuple_size<TInputs>::value;
+        }
+        return isAvailable;
+      }
+
+      constexpr static std::array<bool,nbInputs + 1> isAvailable = getIsAvailable();
+
+      constexpr static bool hasRequired()
+      {
+        constexpr std::array<bool,nbInputs + 1> isOptional = Node::getInputIsOptional();
+        for (size_t i = 0; i < nbInputs; ++i)
+        {
+          if (!isAvailable[i] && !isOptional[i])
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      template <size_t... Is>
+      static auto getAvailable(std::index_sequence<Is...> const &) -> typename SelectedIndices<
+        nbInputs, (isAvailable[Is] ? Is : nbInputs)...>::Sequence;
+
+      /// positions of the inputs which are available
+      typedef decltype(getAvailable(std::make_index_sequence<nbInputs>{})) Sequence;
+    };
+
+    /// returns the named parameter for input InputIdx of node NodeIdx
+    template <size_t NodeIdx, size_t InputIdx, class TInputs>
+    NAMEDPARAMS_FORCE_INLINE static auto getArgument(ResultType& _outputs, TInputs& _inputs)
+    {
+      typedef typename std::tuple_element<NodeIdx,std::tuple<TNodes...>>::type Node;
+      typedef typename std::tuple_element<InputIdx,typename Node::InputKeys>::type InputKey;
+      typedef typename InputKey::type InputType;
+      constexpr size_t producer = findProducer(InputKey::ID);
+
+      if constexpr (producer < nbNodes)
+      {
+        typedef typename std::tuple_element<producer,std::tuple<TNodes...>>::type Producer;
+        typedef typename Producer::OutputType OutputType;
+        constexpr bool isOnlyConsumer = getNbConsumers(producer) == 1;
+
+        static_assert(std::is_reference<InputType>::value
+          ? std::is_convertible<OutputType&,InputType>::value
+          : std::is_constructible<InputType,OutputType&&>::value,
+          "The output of a node cannot be passed to the input of a consumer!");
+        static_assert(!std::is_lvalue_reference<InputType>::value
+          || std::is_const<typename std::remove_reference<InputType>::type>::value
+          || isOnlyConsumer,
+          "An output can only be passed to a non-const reference key if it has one consumer!");
+
+        OutputType& output = *_outputs.template get<producer>();
+        if constexpr (!std::is_reference<InputType>::value && isOnlyConsumer)
+        {
+          return InputKey() = std::move(output);
+        }
+        else
+        {
+          return InputKey() = output;
+        }
+      }
+      else
+      {
+        constexpr size_t passed = findPassed<TInputs>(InputKey::ID);
+        return FixedArgument<typename std::decay<typename std::tuple_element<passed,
+          TInputs>::type>::type>::get(std::get<passed>(_inputs));
+      }
+    }
+
+    /// empties the outputs which were moved into node NodeIdx
+    template <size_t NodeIdx, size_t InputIdx>
+    static void releaseArgument(ResultType& _outputs)
+    {
+      typedef typename std::tuple_element<NodeIdx,std::tuple<TNodes...>>::type Node;
+      typedef typename std::tuple_element<InputIdx,typename Node::InputKeys>::type InputKey;
+      constexpr size_t producer = findProducer(InputKey::ID);
+
+      if constexpr (producer < nbNodes)
+      {
+        if constexpr (!std::is_reference<typename InputKey::type>::value
+          && getNbConsumers(producer) == 1)
+        {
+          _outputs.template get<producer>().reset();
+        }
+      }
+    }
+
+    template <size_t NodeIdx, class TInputs, size_t... Is>
+    void callNode(ResultType& _outputs, TInputs& _inputs, std::index_sequence<Is...> const &) const
+    {
+      _outputs.template get<NodeIdx>() = std::get<NodeIdx>(m_nodes).getFunction()(
+        getArgument<NodeIdx,Is>(_outputs, _inputs)...);
+      (releaseArgument<NodeIdx,Is>(_outputs), ...);
+    }
+
+    template <size_t NodeIdx, class TInputs>
+    void runNode(ResultType& _outputs, TInputs& _inputs) const
+    {
+      static_assert(NodeArguments<NodeIdx,TInputs>::hasRequired(),
+        "A required key of a node is neither the output of a node nor passed to run!");
+      callNode<NodeIdx>(_outputs, _inputs, typename NodeArguments<NodeIdx,TInputs>::Sequence{});
+    }
+
+    template <class TInputs, size_t... Is>
+    constexpr static std::array<void (TaskGraph::*)(ResultType&, TInputs&) const, nbNodes>
+      getRunners(std::index_sequence<Is...> const &)
+    {
+      return { &TaskGraph::runNode<Is,TInputs>... };
+    }
+};
+
+} // end namespace NamedParams
+
+#endif // NAMED_PARAMS_GRAPH_H
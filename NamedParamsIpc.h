@@ -0,0 +1,547 @@
+#ifndef NAMED_PARAMS_IPC_H
+#define NAMED_PARAMS_IPC_H
+
+#include "NamedParamsCallLog.h"
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "NamedParamsIpc.h requires POSIX shared memory"
+#endif
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Named calls between processes through shared memory
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// POSIX shared memory region. A named region is created with shm_open and can be opened
+/// by other processes, an anonymous region (empty name) is shared with child processes
+/// created by fork()
+class SharedMemory
+{
+  private:
+
+    std::string m_name;
+
+    void* m_data;
+
+    size_t m_size;
+
+    bool m_isOwner;
+
+  public:
+
+    /// creates the region if _create is true (replacing an existing region with the same name),
+    /// else opens an existing region of at least _size bytes
+    SharedMemory(const std::string& _name, size_t _size, bool _create)
+      : m_name(_name)
+      , m_data(MAP_FAILED)
+      , m_size(_size)
+      , m_isOwner(_create)
+    {
+      if (m_name.empty())
+      {
+        m_data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+          -1, 0);
+      }
+      else
+      {
+        int fd = ::shm_open(m_name.c_str(), _create ? (O_CREAT | O_TRUNC | O_RDWR) : O_RDWR,
+          0600);
+        if (fd >= 0 && (!_create || ::ftruncate(fd, m_size) == 0))
+        {
+          m_data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (fd >= 0)
+        {
+          ::close(fd);
+        }
+      }
+
+      if (m_data == MAP_FAILED)
+      {
+        if (m_isOwner && !m_name.empty())
+        {
+          ::shm_unlink(m_name.c_str());
+        }
+        throw std::runtime_error("Could not map shared memory " + m_name);
+      }
+    }
+
+    SharedMemory(const SharedMemory&) = delete;
+
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    ~SharedMemory()
+    {
+      ::munmap(m_data, m_size);
+      if (m_isOwner && !m_name.empty())
+      {
+        ::shm_unlink(m_name.c_str());
+      }
+    }
+
+    void* getData() const
+    {
+      return m_data;
+    }
+
+    size_t getSize() const
+    {
+      return m_size;
+    }
+
+};
+
+/// shared state of an IpcRing, followed by the data
+struct IpcRingHeader
+{
+  uint64_t capacity;
+  alignas(64) std::atomic<uint64_t> head; // bytes written, only changed by the producer
+  alignas(64) std::atomic<uint64_t> tail; // bytes read, only changed by the consumer
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+  "IpcRing needs lock-free 64 bit atomics!");
+
+/// lock-free single-producer single-consumer ring buffer of messages in shared memory.
+/// Each message is stored as its 32 bit size followed by its bytes, and may wrap around.
+class IpcRing
+{
+  private:
+
+    IpcRingHeader* m_header;
+
+    char* m_data;
+
+    /// copies _size bytes to the ring at position _pos, wrapping around
+    void copyTo(uint64_t _pos, const void* _source, size_t _size)
+    {
+      const size_t offset = _pos & (m_header->capacity - 1);
+      const size_t first = std::min(_size, size_t(m_header->capacity - offset));
+      std::memcpy(m_data + offset, _source, first);
+      std::memcpy(m_data, static_cast<const char*>(_source) + first, _size - first);
+    }
+
+    /// copies _size bytes from the ring at position _pos, wrapping around
+    void copyFrom(uint64_t _pos, void* _destination, size_t _size) const
+    {
+      const size_t offset = _pos & (m_header->capacity - 1);
+      const size_t first = std::min(_size, size_t(m_header->capacity - offset));
+      std::memcpy(_destination, m_data + offset, first);
+      std::memcpy(static_cast<char*>(_destination) + first, m_data, _size - first);
+    }
+
+  public:
+
+    /// number of bytes needed for a ring with _capacity bytes of data
+    constexpr static size_t getRequiredSize(size_t _capacity)
+    {
+      return sizeof(IpcRingHeader) + _capacity;
+    }
+
+    /// uses the ring at _memory. If _capacity is nonzero, the ring is initialized with
+    /// _capacity bytes of data, which has to be a power of two
+    explicit IpcRing(void* _memory, size_t _capacity = 0)
+      : m_header(static_cast<IpcRingHeader*>(_memory))
+      , m_data(static_cast<char*>(_memory) + sizeof(IpcRingHeader))
+    {
+      if (_capacity != 0)
+      {
+        if ((_capacity & (_capacity - 1)) != 0)
+        {
+          throw std::invalid_argument("IpcRing capacity has to be a power of two!");
+        }
+        new (m_header) IpcRingHeader{_capacity, {0}, {0}};
+      }
+    }
+
+    /// appends a message, returns false if there is not enough space
+    bool tryPush(const char* _message, uint32_t _size)
+    {
+      const uint64_t head = m_header->head.load(std::memory_order_relaxed);
+      const uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+      if (sizeof(uint32_t) + _size > m_header->capacity - (head - tail))
+      {
+        if (sizeof(uint32_t) + _size > m_header->capacity)
+        {
+          throw std::length_error("Message does not fit into the IpcRing!");
+        }
+        return false;
+      }
+
+      copyTo(head, &_size, sizeof(uint32_t));
+      copyTo(head + sizeof(uint32_t), _message, _size);
+      m_header->head.store(head + sizeof(uint32_t) + _size, std::memory_order_release);
+      return true;
+    }
+
+    /// removes the next message and copies it to _message, which has to hold _maxSize bytes.
+    /// Returns the size of the message, or -1 if the ring is empty
+    int64_t tryPop(char* _message, uint32_t _maxSize)
+    {
+      const uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+      const uint64_t head = m_header->head.load(std::memory_order_acquire);
+      if (head == tail)
+      {
+        return -1;
+      }
+
+      uint32_t size;
+      copyFrom(tail, &size, sizeof(uint32_t));
+      if (size > _maxSize)
+      {
+        throw std::length_error("Message does not fit into the buffer!");
+      }
+      copyFrom(tail + sizeof(uint32_t), _message, size);
+      m_header->tail.store(tail + sizeof(uint32_t) + size, std::memory_order_release);
+      return size;
+    }
+
+};
+
+/// spins on _function until it returns true, yields the thread after a while
+template <class TFunction>
+inline void _spinUntil(TFunction&& _function)
+{
+  for (uint64_t i = 0; !_function(); ++i)
+  {
+    if (i >= 1024)
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/// status of an IPC response
+enum class IpcStatus : uint32_t
+{
+  OK = 0,
+  UNKNOWN_FUNCTION = 1,
+  EXCEPTION = 2
+};
+
+/// header of an IPC request. It is followed by the call record, see CallLogSignature.
+/// The signature ID is derived from the name of the function and its key IDs, which are hashes 
+/// of the key names, and so is the same in every process built from the same sources
+struct IpcRequestHeader
+{
+  uint64_t signatureID;
+};
+
+/// header of an IPC response, followed by the bytes of the result
+struct IpcResponseHeader
+{
+  uint64_t signatureID;
+  IpcStatus status;
+};
+
+/// maximum size of a single message
+constexpr uint32_t IPC_MAX_MESSAGE_SIZE = 4096;
+
+/// shared memory with a request ring (client to dispatcher) and a response ring
+class IpcChannel
+{
+  private:
+
+    SharedMemory m_memory;
+
+    IpcRing m_requests;
+
+    IpcRing m_responses;
+
+  public:
+
+    /// creates a channel with two rings of _capacity bytes each if _create is true, else opens
+    /// the channel created by another process with the same name and capacity.
+    /// _name is passed to SharedMemory
+    IpcChannel(const std::string& _name, size_t _capacity, bool _create)
+      : m_memory(_name, 2 * IpcRing::getRequiredSize(_capacity), _create)
+      , m_requests(m_memory.getData(), _create ? _capacity : 0)
+      , m_responses(static_cast<char*>(m_memory.getData()) + IpcRing::getRequiredSize(_capacity),
+        _create ? _capacity : 0)
+    {
+    }
+
+    IpcRing& getRequests()
+    {
+      return m_requests;
+    }
+
+    IpcRing& getResponses()
+    {
+      return m_responses;
+    }
+
+};
+
+/// sends named calls to an IpcDispatcher in another process, and waits for their results.
+/// Arguments are serialized like in a call log, results have to be trivially copyable.
+class IpcClient
+{
+  private:
+
+    IpcChannel& m_channel;
+
+    /// sends the message and waits for the response, returns the size of the result
+    uint32_t exchange(const char* _request, uint32_t _requestSize, uint64_t _signatureID,
+      char* _result)
+    {
+      _spinUntil([&]() { return m_channel.getRequests().tryPush(_request, _requestSize); });
+
+      char response[IPC_MAX_MESSAGE_SIZE];
+      int64_t size = -1;
+      _spinUntil([&]()
+      {
+        size = m_channel.getResponses().tryPop(response, IPC_MAX_MESSAGE_SIZE);
+        return size >= 0;
+      });
+
+      IpcResponseHeader header;
+      std::memcpy(&header, response, sizeof(header));
+      if (header.signatureID != _signatureID)
+      {
+        throw std::runtime_error("IPC response does not match the request!");
+      }
+      if (header.status == IpcStatus::UNKNOWN_FUNCTION)
+      {
+        throw std::runtime_error("Function is not registered in the IPC dispatcher!");
+      }
+      if (header.status != IpcStatus::OK)
+      {
+        throw std::runtime_error("IPC call failed in the dispatcher!");
+      }
+
+      const uint32_t resultSize = static_cast<uint32_t>(size - sizeof(header));
+      if (resultSize > 0)
+      {
+        std::memcpy(_result, response + sizeof(header), resultSize);
+      }
+      return resultSize;
+    }
+
+  public:
+
+    explicit IpcClient(IpcChannel& _channel)
+      : m_channel(_channel)
+    {
+    }
+
+    /// calls _function, registered as _name, in the dispatcher process with positionals and 
+    /// named parameters. Fails at compile time if passed arguments are invalid
+    template <class TFunctionPtr, class... TFunctionKeys, class... Any, std::enable_if_t<
+      KeyFunction<TFunctionPtr,TFunctionKeys...>::template evalAnyError<Any...>(), int> = 0>
+    typename KeyFunction<TFunctionPtr,TFunctionKeys...>::ResultType call(const char* _name,
+      const KeyFunction<TFunctionPtr,TFunctionKeys...>& _function, Any&&... _args)
+    {
+      typedef CallLogSignature<TFunctionPtr, TFunctionKeys...> Signature;
+      typedef typename KeyFunction<TFunctionPtr,TFunctionKeys...>::ResultType ResultType;
+
+      static_assert(std::is_void<ResultType>::value || std::is_trivially_copyable<ResultType>::value,
+        "Only functions with trivially copyable results can be called through IPC!");
+      static_assert(sizeof(IpcRequestHeader) + Signature::maxRecordSize <= IPC_MAX_MESSAGE_SIZE,
+        "Arguments are too large for an IPC message!");
+
+      const uint64_t signatureID = Signature::getSignatureID(_name);
+      char request[sizeof(IpcRequestHeader) + Signature::maxRecordSize];
+      IpcRequestHeader header = {signatureID};
+      std::memcpy(request, &header, sizeof(header));
+
+      const size_t recordSize = _function.apply(
+        [&request](const auto&... _functionArgs)
+        {
+          return _serializeCall(request + sizeof(IpcRequestHeader), _functionArgs...);
+        },
+        std::forward<Any>(_args)...);
+
+      if constexpr (std::is_void<ResultType>::value)
+      {
+        exchange(request, sizeof(header) + recordSize, signatureID, nullptr);
+      }
+      else
+      {
+        LoggedValue<ResultType> result;
+        const uint32_t resultSize = exchange(request, sizeof(header) + recordSize,
+          signatureID, reinterpret_cast<char*>(result.bytes));
+        if (resultSize != sizeof(ResultType))
+        {
+          throw std::runtime_error("IPC result has the wrong size!");
+        }
+        return result.get();
+      }
+    }
+
+    /// makes IpcDispatcher::serve return
+    void stop()
+    {
+      IpcRequestHeader header = {0};
+      _spinUntil([&]()
+      {
+        return m_channel.getRequests().tryPush(reinterpret_cast<const char*>(&header),
+          sizeof(header));
+      });
+    }
+
+};
+
+/// receives calls from IpcClients and calls the registered KeyFunctions
+class IpcDispatcher
+{
+  private:
+
+    /// decodes the record in [_record, _end), calls the function and writes the result
+    /// to _result. Returns the size of the result
+    typedef uint32_t (*Handler)(const void* _function, const char* _record, const char* _end,
+      char* _result);
+
+    IpcChannel& m_channel;
+
+    std::unordered_map<uint64_t, std::pair<const void*, Handler>> m_functions;
+
+    template <class TFunctionPtr, class... TFunctionKeys>
+    static uint32_t handle(const void* _function, const char* _record, const char* _end,
+      char* _result)
+    {
+      typedef KeyFunction<TFunctionPtr,TFunctionKeys...> Function;
+      typedef typename Function::ResultType ResultType;
+
+      const Function& function = *static_cast<const Function*>(_function);
+      uint32_t resultSize = 0;
+
+      _decodeCall<TFunctionPtr, TFunctionKeys...>(_record, _end,
+        [&](auto&&... _args)
+        {
+          if constexpr (std::is_void<ResultType>::value)
+          {
+            function.call(std::forward<decltype(_args)>(_args)...);
+          }
+          else
+          {
+            const ResultType result = function.call(std::forward<decltype(_args)>(_args)...);
+            std::memcpy(_result, &result, sizeof(ResultType));
+            resultSize = sizeof(ResultType);
+          }
+        },
+        std::make_index_sequence<sizeof...(TFunctionKeys)>{});
+
+      return resultSize;
+    }
+
+  public:
+
+    explicit IpcDispatcher(IpcChannel& _channel)
+      : m_channel(_channel)
+    {
+    }
+
+    /// makes _function callable by clients under _name, it has to outlive the dispatcher.
+    /// Throws if a function with the same name and keys is already registered
+    template <class TFunctionPtr, class... TFunctionKeys>
+    void registerFunction(const char* _name, 
+      const KeyFunction<TFunctionPtr,TFunctionKeys...>& _function)
+    {
+      typedef CallLogSignature<TFunctionPtr, TFunctionKeys...> Signature;
+      typedef typename KeyFunction<TFunctionPtr,TFunctionKeys...>::ResultType ResultType;
+
+      static_assert(std::is_void<ResultType>::value || std::is_trivially_copyable<ResultType>::value,
+        "Only functions with trivially copyable results can be called through IPC!");
+      static_assert(sizeof(IpcResponseHeader) + sizeof(typename std::conditional<
+        std::is_void<ResultType>::value, char, ResultType>::type) <= IPC_MAX_MESSAGE_SIZE,
+        "Result is too large for an IPC message!");
+
+      const uint64_t signatureID = Signature::getSignatureID(_name);
+      if (signatureID == 0)
+      {
+        throw std::runtime_error(std::string("Function ") + _name 
+          + " has the ID of the IPC stop request!");
+      }
+      if (!m_functions.emplace(signatureID, std::make_pair(static_cast<const void*>(&_function),
+        &handle<TFunctionPtr, TFunctionKeys...>)).second)
+      {
+        throw std::runtime_error(std::string("Function ") + _name 
+          + " is already registered in the IPC dispatcher!");
+      }
+    }
+
+    /// handles the next request if there is one. Returns false if there was no request,
+    /// or if it was a stop request
+    bool poll(bool* _stopped = nullptr)
+    {
+      char request[IPC_MAX_MESSAGE_SIZE];
+      const int64_t size = m_channel.getRequests().tryPop(request, IPC_MAX_MESSAGE_SIZE);
+      if (size < (int64_t)sizeof(IpcRequestHeader))
+      {
+        return false;
+      }
+
+      IpcRequestHeader header;
+      std::memcpy(&header, request, sizeof(header));
+      if (header.signatureID == 0)
+      {
+        if (_stopped)
+        {
+          *_stopped = true;
+        }
+        return false;
+      }
+
+      char response[IPC_MAX_MESSAGE_SIZE];
+      IpcResponseHeader responseHeader = {header.signatureID, IpcStatus::OK};
+      uint32_t resultSize = 0;
+
+      auto iter = m_functions.find(header.signatureID);
+      if (iter == m_functions.end())
+      {
+        responseHeader.status = IpcStatus::UNKNOWN_FUNCTION;
+      }
+      else
+      {
+        try
+        {
+          resultSize = iter->second.second(iter->second.first, request + sizeof(header),
+            request + size, response + sizeof(responseHeader));
+        }
+        catch (...)
+        {
+          responseHeader.status = IpcStatus::EXCEPTION;
+          resultSize = 0;
+        }
+      }
+
+      std::memcpy(response, &responseHeader, sizeof(responseHeader));
+      _spinUntil([&]()
+      {
+        return m_channel.getResponses().tryPush(response, sizeof(responseHeader) + resultSize);
+      });
+      return true;
+    }
+
+    /// handles requests until a client calls stop(), returns the number of handled calls
+    uint64_t serve()
+    {
+      uint64_t nbCalls = 0;
+      bool stopped = false;
+      _spinUntil([&]()
+      {
+        if (poll(&stopped))
+        {
+          ++nbCalls;
+        }
+        return stopped;
+      });
+      return nbCalls;
+    }
+
+};
+
+} // end namespace NamedParams
+
+#endif // NAMED_PARAMS_IPC_H
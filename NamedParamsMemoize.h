@@ -0,0 +1,369 @@
+#ifndef NAMED_PARAMS_MEMOIZE_H
+#define NAMED_PARAMS_MEMOIZE_H
+
+#include "NamedParams.h"
+
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Memoization of pure KeyFunctions
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// combines the hash of a single argument into _seed
+template <class T>
+inline void _hashCombine(size_t& _seed, const T& _value)
+{
+  _seed ^= std::hash<T>{}(_value) + 0x9e3779b97f4a7c15ULL + (_seed << 6) + (_seed >> 2);
+}
+
+/// key of a MemoKeyFunction cache entry: the canonical (function-ordered) arguments and their hash
+/// absent optionals are stored as std::nullopt, so they are part of the hash and the comparison.
+/// Lookups use a MemoKey of references to the passed arguments, which compares equal to the
+/// stored MemoKey of values
+template <class TArgumentTuple>
+struct MemoKey
+{
+  size_t hash;
+  TArgumentTuple arguments;
+
+  template <class DArgumentTuple>
+  bool operator==(const MemoKey<DArgumentTuple>& _other) const
+  {
+    return hash == _other.hash && arguments == _other.arguments;
+  }
+};
+
+/// returns the precomputed hash of a MemoKey
+struct MemoKeyHash
+{
+  template <class TArgumentTuple>
+  size_t operator()(const MemoKey<TArgumentTuple>& _key) const
+  {
+    return _key.hash;
+  }
+};
+
+/// hit and miss counters of a memoization cache
+struct MemoStatistics
+{
+  uint64_t nbHits;
+  uint64_t nbMisses;
+  uint64_t nbEvictions;
+  size_t size;
+};
+
+/// bounded least-recently-used cache, split into shards which each have their own lock
+/// TKey has to provide a precomputed hash, which is also used to select the shard.
+/// find and erase accept any key which THash accepts and which compares equal to TKey, so a 
+/// lookup does not need to build a TKey
+template <class TKey, class TValue, class THash>
+class ShardedLruCache
+{
+  public:
+
+    ShardedLruCache(size_t _capacity, size_t _nbShards)
+      : m_nbShards(_nbShards > 0 ? _nbShards : 1)
+      , m_shards(new Shard[m_nbShards])
+    {
+      const size_t shardCapacity = (_capacity + m_nbShards - 1) / m_nbShards;
+      for (size_t i = 0; i < m_nbShards; ++i)
+      {
+        m_shards[i].capacity = (shardCapacity > 0) ? shardCapacity : 1;
+      }
+    }
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    /// returns a copy of the cached value and marks it as most recently used
+    template <class TLookup>
+    std::optional<TValue> find(const TLookup& _key)
+    {
+      Shard& shard = getShard(_key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      auto iter = findIndex(shard, _key);
+      if (iter == shard.index.end())
+      {
+        ++shard.nbMisses;
+        return std::nullopt;
+      }
+
+      ++shard.nbHits;
+      shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+      return iter->second->second;
+    }
+
+    /// inserts a value, evicting the least recently used entry of the shard if it is full
+    void insert(TKey&& _key, TValue&& _value)
+    {
+      Shard& shard = getShard(_key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      // another thread might have computed the same value in the meantime
+      if (findIndex(shard, _key) != shard.index.end())
+      {
+        return;
+      }
+
+      if (shard.entries.size() >= shard.capacity)
+      {
+        const typename EntryList::iterator last = std::prev(shard.entries.end());
+        auto range = shard.index.equal_range(THash{}(last->first));
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+          if (iter->second == last)
+          {
+            shard.index.erase(iter);
+            break;
+          }
+        }
+        shard.entries.pop_back();
+        ++shard.nbEvictions;
+      }
+
+      const size_t hash = THash{}(_key);
+      shard.entries.emplace_front(std::move(_key), std::move(_value));
+      shard.index.emplace(hash, shard.entries.begin());
+    }
+
+    /// removes a single entry, returns true if it was present
+    template <class TLookup>
+    bool erase(const TLookup& _key)
+    {
+      Shard& shard = getShard(_key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      auto iter = findIndex(shard, _key);
+      if (iter == shard.index.end())
+      {
+        return false;
+      }
+
+      shard.entries.erase(iter->second);
+      shard.index.erase(iter);
+      return true;
+    }
+
+    /// removes all entries, the statistics are kept
+    void clear()
+    {
+      for (size_t i = 0; i < m_nbShards; ++i)
+      {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        m_shards[i].index.clear();
+        m_shards[i].entries.clear();
+      }
+    }
+
+    MemoStatistics getStatistics() const
+    {
+      MemoStatistics stats = {0, 0, 0, 0};
+      for (size_t i = 0; i < m_nbShards; ++i)
+      {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        stats.nbHits += m_shards[i].nbHits;
+        stats.nbMisses += m_shards[i].nbMisses;
+        stats.nbEvictions += m_shards[i].nbEvictions;
+        stats.size += m_shards[i].entries.size();
+      }
+      return stats;
+    }
+
+  private:
+
+    typedef std::list<std::pair<TKey,TValue>> EntryList;
+
+    /// entries by hash, keys with the same hash are compared in findIndex
+    typedef std::unordered_multimap<size_t, typename EntryList::iterator> Index;
+
+    struct Shard
+    {
+      mutable std::mutex mutex;
+      size_t capacity = 1;
+      EntryList entries;
+      Index index;
+      uint64_t nbHits = 0;
+      uint64_t nbMisses = 0;
+      uint64_t nbEvictions = 0;
+    };
+
+    /// returns the index entry of the key which is equal to _key, or the end of the index
+    template <class TLookup>
+    static typename Index::iterator findIndex(Shard& _shard, const TLookup& _key)
+    {
+      auto range = _shard.index.equal_range(THash{}(_key));
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        if (iter->second->first == _key)
+        {
+          return iter;
+        }
+      }
+      return _shard.index.end();
+    }
+
+    template <class TLookup>
+    Shard& getShard(const TLookup& _key)
+    {
+      // mix the hash, since std::hash is the identity for integers on most implementations
+      const uint64_t mixed = static_cast<uint64_t>(THash{}(_key)) * 0x9e3779b97f4a7c15ULL;
+      return m_shards[(mixed >> 32) % m_nbShards];
+    }
+
+    size_t m_nbShards;
+    std::unique_ptr<Shard[]> m_shards;
+};
+
+/// MemoKeyFunction wraps a pure function like KeyFunction, but caches its results.
+/// The arguments are reordered into the function order before hashing, so the order of the
+/// named parameters does not matter. All argument types need a std::hash specialization and
+/// operator==, and the result type has to be copyable.
+template <class TFunctionPtr, class... TFunctionKeys>
+class MemoKeyFunction
+{
+  private:
+
+    typedef KeyFunction<TFunctionPtr, TFunctionKeys...> BaseFunction;
+
+    typedef FunctionTraits<typename std::remove_pointer<TFunctionPtr>::type> KeyFunctionTraits;
+
+    typedef typename KeyFunctionTraits::ResultType ResultType;
+
+    typedef std::tuple<typename std::decay<typename TFunctionKeys::type>::type...> ArgumentTuple;
+
+    typedef MemoKey<ArgumentTuple> CacheKey;
+
+    static_assert(!std::is_void<ResultType>::value, "Cannot memoize a function returning void!");
+
+    static_assert(
+      !std::disjunction<std::conjunction<
+        std::is_lvalue_reference<typename TFunctionKeys::type>,
+        std::negation<std::is_const<typename std::remove_reference<typename TFunctionKeys::type>::type>>
+      >...>::value,
+      "Cannot memoize a function with non-const reference arguments!");
+
+    BaseFunction m_function;
+
+    mutable ShardedLruCache<CacheKey, ResultType, MemoKeyHash> m_cache;
+
+    /// element of a lookup key: a reference to the passed argument if it already has the stored 
+    /// type TStored, otherwise the argument converted to TStored (e.g. std::nullopt_t, which is 
+    /// passed for absent optionals)
+    template <class TStored, class D>
+    using LookupElement = typename std::conditional<
+      std::is_same<typename std::decay<D>::type, TStored>::value, const TStored&, TStored>::type;
+
+    /// returns the key of the passed arguments, which refers to them instead of copying them.
+    /// The arguments are only copied into a CacheKey when a result is inserted
+    template <class... DArgs, size_t... Is>
+    static auto makeLookup(std::index_sequence<Is...> const &, const DArgs&... _args)
+    {
+      typedef std::tuple<LookupElement<
+        typename std::tuple_element<Is,ArgumentTuple>::type, DArgs>...> LookupTuple;
+
+      MemoKey<LookupTuple> key = {0, LookupTuple(_args...)};
+      std::apply([&](const auto&... _values) { (_hashCombine(key.hash, _values), ...); },
+        key.arguments);
+      return key;
+    }
+
+    template <class... DArgs>
+    static auto makeLookup(const DArgs&... _args)
+    {
+      return makeLookup(std::index_sequence_for<DArgs...>{}, _args...);
+    }
+
+  public:
+
+    /// constructor for non-member functions with the maximum number of cached results
+    /// and the number of independently locked shards
+    template <class DFunctionPtr, class... DFunctionKeys>
+    MemoKeyFunction(size_t _capacity, size_t _nbShards, DFunctionPtr _function,
+      const DFunctionKeys&... _keys)
+      : m_function(_function, _keys...)
+      , m_cache(_capacity, _nbShards)
+    {
+    }
+
+    /// calls the function, or returns the cached result if it was called with the same
+    /// arguments before
+    template <class... Any, std::enable_if_t<BaseFunction::template evalAnyError<Any...>(), int> = 0>
+    ResultType operator()(Any&&... _args) const
+    {
+      return m_function.apply(
+        [this](auto&&... _functionArgs) -> ResultType
+        {
+          const auto lookup = makeLookup(_functionArgs...);
+
+          std::optional<ResultType> cached = m_cache.find(lookup);
+          if (cached)
+          {
+            return std::move(*cached);
+          }
+
+          // copied before the call, which may move from the arguments
+          CacheKey key = {lookup.hash, ArgumentTuple(lookup.arguments)};
+          ResultType result = m_function.call(
+            std::forward<decltype(_functionArgs)>(_functionArgs)...);
+          m_cache.insert(std::move(key), ResultType(result));
+          return result;
+        },
+        std::forward<Any>(_args)...);
+    }
+
+    /// removes the cached result for the given arguments, returns true if it was cached
+    template <class... Any, std::enable_if_t<BaseFunction::template evalAnyError<Any...>(), int> = 0>
+    bool invalidate(Any&&... _args) const
+    {
+      return m_function.apply(
+        [this](auto&&... _functionArgs) -> bool
+        {
+          return m_cache.erase(makeLookup(_functionArgs...));
+        },
+        std::forward<Any>(_args)...);
+    }
+
+    /// removes all cached results
+    void invalidate() const
+    {
+      m_cache.clear();
+    }
+
+    MemoStatistics getStatistics() const
+    {
+      return m_cache.getStatistics();
+    }
+
+    const BaseFunction& getKeyFunction() const
+    {
+      return m_function;
+    }
+
+};
+
+template <class DFunctionPtr, class... DFunctionKeys>
+MemoKeyFunction(size_t _capacity, size_t _nbShards, DFunctionPtr _function,
+  const DFunctionKeys&... _keys) -> MemoKeyFunction<DFunctionPtr,DFunctionKeys...>;
+
+} // end namespace NamedParams
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                       MACRO MAGIC
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define NAMEDPARAMS_MEMOIZE(functionName, capacity, nbShards, function, list) \
+  NAMEDPARAMS_DECLARE_KEYS(function, list) \
+  const inline NamedParams::MemoKeyFunction functionName(capacity, nbShards, function, \
+    _NAMEDPARAMS_UNPAREN list);
+
+#endif // NAMED_PARAMS_MEMOIZE_H
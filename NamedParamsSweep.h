@@ -0,0 +1,295 @@
+#ifndef NAMED_PARAMS_SWEEP_H
+#define NAMED_PARAMS_SWEEP_H
+
+#include "NamedParams.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NamedParams
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+///  Cartesian parameter sweeps
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// a fixed named parameter, which is passed to every grid point of a sweep
+template <class T>
+struct SweepArgument
+{
+  static_assert(IsAssignedKey<T>::value, "Only named parameters can be passed to sweep!");
+
+  typedef typename AssignedKeyType<T>::type KeyType;
+
+  static_assert(!std::is_lvalue_reference<typename KeyType::type>::value
+    || std::is_const<typename std::remove_reference<typename KeyType::type>::type>::value,
+    "Non-const references cannot be passed to sweep, they would be shared between the threads!");
+
+  constexpr static bool isSwept = false;
+
+  static size_t getSize(const T&)
+  {
+    return 1;
+  }
+
+  /// assigns the key again, so by-value arguments are copied for each grid point
+  static auto get(T& _argument, size_t)
+  {
+    return FixedArgument<T>::get(_argument);
+  }
+};
+
+/// a swept named parameter, the grid has a dimension for it
+template <class TKey>
+struct SweepArgument<KeyValues<TKey>>
+{
+  constexpr static bool isSwept = true;
+
+  static size_t getSize(const KeyValues<TKey>& _values)
+  {
+    return _values.size();
+  }
+
+  static auto get(const KeyValues<TKey>& _values, size_t _idx)
+  {
+    return TKey() = _values[_idx];
+  }
+};
+
+/// the named parameter passed to the function at a single grid point
+template <class T>
+using SweepPointArgument = decltype(SweepArgument<typename std::decay<T>::type>::get(
+  std::declval<typename std::decay<T>::type&>(), 0));
+
+/// results of a sweep, stored in row-major order of the swept keys
+/// (the last swept key is the fastest index)
+template <class R, size_t NbDims>
+class SweepResult
+{
+  public:
+
+    explicit SweepResult(const std::array<size_t,NbDims>& _shape)
+      : m_shape(_shape)
+      , m_size(1)
+    {
+      for (size_t extent : m_shape)
+      {
+        m_size *= extent;
+      }
+      m_values.reset(new R[m_size]);
+    }
+
+    size_t size() const
+    {
+      return m_size;
+    }
+
+    /// number of values of each swept key, in the order they were passed
+    const std::array<size_t,NbDims>& getShape() const
+    {
+      return m_shape;
+    }
+
+    /// indices of the swept key values for grid point _point
+    std::array<size_t,NbDims> getIndices(size_t _point) const
+    {
+      std::array<size_t,NbDims> indices = {};
+      for (size_t i = NbDims; i-- > 0;)
+      {
+        indices[i] = _point % m_shape[i];
+        _point /= m_shape[i];
+      }
+      return indices;
+    }
+
+    R& operator[](size_t _point)
+    {
+      return m_values[_point];
+    }
+
+    const R& operator[](size_t _point) const
+    {
+      return m_values[_point];
+    }
+
+    /// result for the given index of each swept key
+    template <class... Indices>
+    const R& operator()(Indices... _indices) const
+    {
+      static_assert(sizeof...(Indices) == NbDims, "One index per swept key is needed!");
+      const std::array<size_t,NbDims> indices = {size_t(_indices)...};
+      size_t point = 0;
+      for (size_t i = 0; i < NbDims; ++i)
+      {
+        point = point * m_shape[i] + indices[i];
+      }
+      return m_values[point];
+    }
+
+    const R* begin() const
+    {
+      return m_values.get();
+    }
+
+    const R* end() const
+    {
+      return m_values.get() + m_size;
+    }
+
+  private:
+
+    std::array<size_t,NbDims> m_shape;
+
+    size_t m_size;
+
+    std::unique_ptr<R[]> m_values;
+};
+
+/// calls _function with the arguments of a single grid point
+template <class TFunction, class TArguments, size_t NbArgs, size_t... Is>
+inline decltype(auto) _callSweepPoint(const TFunction& _function, TArguments& _arguments,
+  const std::array<size_t,NbArgs>& _indices, std::index_sequence<Is...> const &)
+{
+  return _function(SweepArgument<typename std::decay<
+    typename std::tuple_element<Is,TArguments>::type>::type>::get(
+      std::get<Is>(_arguments), _indices[Is])...);
+}
+
+/// calls _work for each point in [0, _nbPoints) on _nbThreads threads, including the calling 
+/// thread. The points are handed out one at a time, so threads which get cheap points take 
+/// more of them. The first exception is rethrown after all threads have finished
+template <class TWork>
+inline void _runSweep(size_t _nbThreads, size_t _nbPoints, const TWork& _work)
+{
+  std::atomic<size_t> next(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto work = [&]()
+  {
+    for (size_t point = next.fetch_add(1, std::memory_order_relaxed); point < _nbPoints;
+      point = next.fetch_add(1, std::memory_order_relaxed))
+    {
+      try
+      {
+        _work(point);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+        next.store(_nbPoints, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  const size_t nbWorkers = std::max(std::min(_nbThreads, _nbPoints), size_t(1));
+  std::vector<std::thread> threads;
+  threads.reserve(nbWorkers - 1);
+  for (size_t i = 1; i < nbWorkers; ++i)
+  {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+/// calls _function for each point of the Cartesian product of the swept keys on _nbThreads
+/// threads. Swept keys are assigned braced lists, e.g. kScaling = {0.5, 1.0}, all other named 
+/// parameters are passed to every point. The arguments of a point are assigned on the stack
+/// of the worker, by-value arguments are copied for each point.
+/// Returns a SweepResult, or the number of points for functions returning void.
+/// fails at compile time if the arguments of a single point are invalid
+template <class TFunctionPtr, class... TFunctionKeys, class... Any, std::enable_if_t<
+  KeyFunction<TFunctionPtr,TFunctionKeys...>::template evalAnyError<SweepPointArgument<Any>...>(),
+  int> = 0>
+auto sweep(size_t _nbThreads, const KeyFunction<TFunctionPtr,TFunctionKeys...>& _function,
+  Any&&... _args)
+{
+  typedef typename KeyFunction<TFunctionPtr,TFunctionKeys...>::ResultType ResultType;
+  constexpr size_t nbArgs = sizeof...(Any);
+  constexpr std::array<bool,nbArgs + 1> isSwept =
+  {
+    SweepArgument<typename std::decay<Any>::type>::isSwept..., false
+  };
+  constexpr size_t nbDims = (size_t(SweepArgument<typename std::decay<Any>::type>::isSwept)
+    + ... + 0);
+
+  // fixed keys have a single value
+  const std::array<size_t,nbArgs + 1> sizes =
+  {
+    SweepArgument<typename std::decay<Any>::type>::getSize(_args)..., 1
+  };
+
+  std::array<size_t,nbDims> shape = {};
+  size_t nbPoints = 1;
+  for (size_t i = 0, dim = 0; i < nbArgs; ++i)
+  {
+    nbPoints *= sizes[i];
+    if (isSwept[i])
+    {
+      shape[dim++] = sizes[i];
+    }
+  }
+
+  auto arguments = std::forward_as_tuple(_args...);
+
+  auto callPoint = [&](size_t _point) -> decltype(auto)
+  {
+    std::array<size_t,nbArgs + 1> indices = {};
+    for (size_t i = nbArgs; i-- > 0;)
+    {
+      indices[i] = _point % sizes[i];
+      _point /= sizes[i];
+    }
+    return _callSweepPoint(_function, arguments, indices, std::make_index_sequence<nbArgs>{});
+  };
+
+  if constexpr (std::is_void<ResultType>::value)
+  {
+    _runSweep(_nbThreads, nbPoints, callPoint);
+    return nbPoints;
+  }
+  else
+  {
+    static_assert(std::is_default_constructible<ResultType>::value,
+      "Only functions with default constructible results can be swept!");
+
+    SweepResult<ResultType,nbDims> result(shape);
+    _runSweep(_nbThreads, nbPoints, [&](size_t _point)
+    {
+      result[_point] = callPoint(_point);
+    });
+    return result;
+  }
+}
+
+/// sweep on all hardware threads
+template <class TFunctionPtr, class... TFunctionKeys, class... Any, std::enable_if_t<
+  KeyFunction<TFunctionPtr,TFunctionKeys...>::template evalAnyError<SweepPointArgument<Any>...>(),
+  int> = 0>
+auto sweep(const KeyFunction<TFunctionPtr,TFunctionKeys...>& _function, Any&&... _args)
+{
+  return sweep(size_t(std::thread::hardware_concurrency()), _function,
+    std::forward<Any>(_args)...);
+}
+
+} // end namespace NamedParams
+
+#endif // NAMED_PARAMS_SWEEP_H
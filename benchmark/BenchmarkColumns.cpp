@@ -0,0 +1,99 @@
+#include "NamedParamsColumns.h"
+#include "BenchmarkRun.h"
+
+#include <string>
+#include <vector>
+
+// a pass over two keys of a table with several keys per row, stored as an array of structs of
+// optionals and as NamedParams::NamedColumns
+
+#ifndef BENCHMARK_NB_ROWS
+#define BENCHMARK_NB_ROWS 1000000
+#endif
+
+#ifndef BENCHMARK_NB_PASSES
+#define BENCHMARK_NB_PASSES 20
+#endif
+
+double weight(double _charge, std::optional<double> _scaling)
+{
+  return _charge * _scaling.value_or(1.0);
+}
+
+#define WEIGHT_VARS (kCharge, kScaling)
+NAMEDPARAMS_PARAMETRIZE(np_weight, &weight, WEIGHT_VARS)
+
+struct Position
+{
+  double x, y, z;
+};
+
+// keys which are stored, but not read by the pass
+std::string describe(const std::string& _name, std::optional<Position> _position, int _nbElectrons)
+{
+  return _name + (_position ? " at a position" : "") + std::to_string(_nbElectrons);
+}
+
+#define DESCRIBE_VARS (kName, kPosition, kNbElectrons)
+NAMEDPARAMS_PARAMETRIZE(np_describe, &describe, DESCRIBE_VARS)
+
+struct Row
+{
+  std::string name;
+  std::optional<Position> position;
+  int nbElectrons;
+  double charge;
+  std::optional<double> scaling;
+};
+
+int main()
+{
+  std::vector<Row> rows;
+  NamedParams::NamedColumns<decltype(kName), decltype(kPosition), decltype(kNbElectrons),
+    decltype(kCharge), decltype(kScaling)> columns;
+
+  rows.reserve(BENCHMARK_NB_ROWS);
+  columns.reserve(BENCHMARK_NB_ROWS);
+  for (size_t i = 0; i < BENCHMARK_NB_ROWS; ++i)
+  {
+    const std::optional<double> scaling = (i % 3 == 0) ? std::nullopt
+      : std::optional<double>(0.5);
+    rows.push_back(Row{"atom", Position{0.0, 0.0, 0.0}, int(i % 7), double(i % 5), scaling});
+    columns.pushBack(kName = "atom", kPosition = Position{0.0, 0.0, 0.0},
+      kNbElectrons = int(i % 7), kCharge = double(i % 5), kScaling = scaling);
+  }
+
+  runBenchmark("array of structs", BENCHMARK_NB_PASSES, [&]()
+  {
+    double sum = 0;
+    for (const Row& row : rows)
+    {
+      sum += weight(row.charge, row.scaling);
+    }
+    return sum;
+  }, BENCHMARK_NB_ROWS, "row");
+
+  runBenchmark("NamedColumns, loop over columns", BENCHMARK_NB_PASSES, [&]()
+  {
+    const double* charges = columns[kCharge].data();
+    const std::optional<double>* scalings = columns[kScaling].data();
+    double sum = 0;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+      sum += weight(charges[i], scalings[i]);
+    }
+    return sum;
+  }, BENCHMARK_NB_ROWS, "row");
+
+  runBenchmark("NamedColumns, apply", BENCHMARK_NB_PASSES, [&]()
+  {
+    double sum = 0;
+    for (double value : columns.apply(np_weight))
+    {
+      sum += value;
+    }
+    return sum;
+  }, BENCHMARK_NB_ROWS, "row");
+
+  return 0;
+}
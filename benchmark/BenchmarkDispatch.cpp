@@ -0,0 +1,40 @@
+#include "NamedParams.h"
+#include "BenchmarkRun.h"
+
+// overhead of named calls through a KeyFunction compared with direct calls. Built at -O0 and -O2,
+// the -O0 build tracks the overhead in debug and sanitizer builds
+
+#ifndef BENCHMARK_NB_CALLS
+#define BENCHMARK_NB_CALLS 10000000
+#endif
+
+[[gnu::noinline]] double weigh(double _value, int _order, const double& _weight,
+  std::optional<double> _scaling, std::optional<int> _shift)
+{
+  return (_value + _order * _weight) * _scaling.value_or(1.0) + _shift.value_or(0);
+}
+
+#define WEIGH_VARS (kValue, kOrder, kWeight, kScaling, kShift)
+NAMEDPARAMS_PARAMETRIZE(np_weigh, &weigh, WEIGH_VARS)
+
+int main()
+{
+  const double weight = 0.5;
+
+  runBenchmark("direct", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return weigh(1.0, _i, weight, 2.0, std::nullopt);
+  });
+
+  runBenchmark("KeyFunction positionals", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return np_weigh(1.0, _i, weight, 2.0);
+  });
+
+  runBenchmark("KeyFunction named", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return np_weigh(kScaling = 2.0, kWeight = weight, kOrder = _i, kValue = 1.0);
+  });
+
+  return 0;
+}
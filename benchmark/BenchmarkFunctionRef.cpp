@@ -0,0 +1,91 @@
+#include "NamedParams.h"
+#include "BenchmarkRun.h"
+
+#include <functional>
+#include <vector>
+
+// calls to one of several implementations with the same keys, chosen at runtime, through
+// NamedParams::NamedFunctionRef and std::function
+
+#ifndef BENCHMARK_NB_CALLS
+#define BENCHMARK_NB_CALLS 10000000
+#endif
+
+[[gnu::noinline]] double solveDiis(const std::vector<double>& _input, int _maxIter,
+  std::optional<double> _damping)
+{
+  return _input[_maxIter % 4] * _damping.value_or(1.0);
+}
+
+[[gnu::noinline]] double solveLevelShift(const std::vector<double>& _input, int _maxIter,
+  std::optional<double> _damping)
+{
+  return _input[(_maxIter + 1) % 4] - _damping.value_or(0.0);
+}
+
+#define SOLVER_VARS (kInput, kMaxIter, kDamping)
+NAMEDPARAMS_PARAMETRIZE(np_solveDiis, &solveDiis, SOLVER_VARS)
+constexpr inline NamedParams::KeyFunction np_solveLevelShift(
+  NamedParams::FunctionConstant<&solveLevelShift>{}, kInput, kMaxIter, kDamping);
+
+typedef NamedParams::NamedFunctionRef<double, decltype(kInput), decltype(kMaxIter),
+  decltype(kDamping)> SolverRef;
+
+typedef std::function<double(const std::vector<double>&, int, std::optional<double>)> 
+  SolverFunction;
+
+int main(int _argc, char**)
+{
+  const std::vector<double> input = {1.0, 2.0, 3.0, 4.0};
+  // the implementation is only known at runtime
+  const size_t choice = (_argc > 5) ? 0 : 1;
+
+  const SolverRef solverRefs[] = {np_solveDiis, np_solveLevelShift};
+  const SolverRef& solverRef = solverRefs[choice];
+
+  runBenchmark("KeyFunction", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return np_solveLevelShift(kDamping = 0.5, kMaxIter = _i, kInput = input);
+  });
+
+  runBenchmark("NamedFunctionRef", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return solverRef(kDamping = 0.5, kMaxIter = _i, kInput = input);
+  });
+
+  const SolverFunction solverFunctions[] = {&solveDiis, &solveLevelShift};
+  const SolverFunction& solverFunction = solverFunctions[choice];
+
+  runBenchmark("std::function", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return solverFunction(input, _i, 0.5);
+  });
+
+  // rebinding to a callable with state, e.g. a new table entry for each call
+  const double scale = 2.0;
+  const double shift = 1.0;
+  const double offset = 0.5;
+
+  runBenchmark("NamedFunctionRef, rebound to a lambda", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    auto scaled = [&input, scale, shift, offset](const std::vector<double>& _input, int _maxIter,
+      std::optional<double> _damping)
+    {
+      return solveDiis(_input, _maxIter, _damping) * scale + shift + offset + input[0];
+    };
+    SolverRef ref = scaled;
+    return ref(kDamping = 0.5, kMaxIter = _i, kInput = input);
+  });
+
+  runBenchmark("std::function, rebound to a lambda", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    SolverFunction function = [&input, scale, shift, offset](const std::vector<double>& _input,
+      int _maxIter, std::optional<double> _damping)
+    {
+      return solveDiis(_input, _maxIter, _damping) * scale + shift + offset + input[0];
+    };
+    return function(input, _i, 0.5);
+  });
+
+  return 0;
+}
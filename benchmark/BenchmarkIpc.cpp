@@ -0,0 +1,62 @@
+#include "NamedParamsIpc.h"
+#include "BenchmarkRun.h"
+
+#include <string>
+
+#include <sys/wait.h>
+
+// round-trip latency of named calls to another process through NamedParams::IpcClient,
+// compared with named calls in the same process
+
+#ifndef BENCHMARK_NB_CALLS
+#define BENCHMARK_NB_CALLS 1000000
+#endif
+
+[[gnu::noinline]] double scale(double _value, std::optional<double> _factor,
+  std::optional<double> _offset)
+{
+  return _value * _factor.value_or(1.0) + _offset.value_or(0.0);
+}
+
+#define SCALE_VARS (kValue, kFactor, kOffset)
+NAMEDPARAMS_PARAMETRIZE(np_scale, &scale, SCALE_VARS)
+
+int main()
+{
+  const std::string name = "/NamedParamsBenchmarkIpc" + std::to_string(::getpid());
+  const size_t capacity = 1 << 16;
+
+  NamedParams::IpcChannel channel(name, capacity, true);
+
+  const pid_t pid = ::fork();
+  if (pid == 0)
+  {
+    NamedParams::IpcChannel workerChannel(name, capacity, false);
+    NamedParams::IpcDispatcher dispatcher(workerChannel);
+    dispatcher.registerFunction("scale", np_scale);
+    dispatcher.serve();
+    ::_exit(0);
+  }
+
+  NamedParams::IpcClient client(channel);
+
+  runBenchmark("local named call", BENCHMARK_NB_CALLS, [](double _value)
+  {
+    return np_scale(kOffset = 1.0, kValue = _value);
+  });
+
+  runBenchmark("IPC named call", BENCHMARK_NB_CALLS, [&client](double _value)
+  {
+    return client.call("scale", np_scale, kOffset = 1.0, kValue = _value);
+  });
+
+  runBenchmark("IPC named call, all arguments", BENCHMARK_NB_CALLS, [&client](double _value)
+  {
+    return client.call("scale", np_scale, kOffset = 1.0, kFactor = 2.0, kValue = _value);
+  });
+
+  client.stop();
+  ::waitpid(pid, nullptr, 0);
+
+  return 0;
+}
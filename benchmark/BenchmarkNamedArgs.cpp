@@ -0,0 +1,68 @@
+#include "NamedParams.h"
+#include "BenchmarkRun.h"
+
+#include <vector>
+
+// calls of a function with a wide signature through a KeyFunction, which marshals each argument 
+// into its parameter position, and through a KeyArgsFunction, which passes a single pointer to 
+// the addresses of the arguments (NamedParams::NamedArgs)
+
+#ifndef BENCHMARK_NB_CALLS
+#define BENCHMARK_NB_CALLS 10000000
+#endif
+
+[[gnu::noinline]] double wide(double _x0, double _x1, double _x2, double _x3, double _x4, 
+  double _x5, double _x6, double _x7, int _n0, int _n1, int _n2, int _n3, 
+  const std::vector<double>& _weights, std::optional<double> _s0, std::optional<double> _s1, 
+  std::optional<double> _s2)
+{
+  return (_x0 + _x1 + _x2 + _x3 + _x4 + _x5 + _x6 + _x7) * _weights[_n0 % 4]
+    + (_n0 + _n1 + _n2 + _n3) * _s0.value_or(1.0) + _s1.value_or(0.0) - _s2.value_or(0.0);
+}
+
+#define WIDE_VARS (kX0, kX1, kX2, kX3, kX4, kX5, kX6, kX7, kN0, kN1, kN2, kN3, kWeights, \
+  kS0, kS1, kS2)
+NAMEDPARAMS_PARAMETRIZE(np_wide, &wide, WIDE_VARS)
+
+// the same keys, read from a NamedArgs
+typedef NamedParams::NamedArgs<decltype(kX0), decltype(kX1), decltype(kX2), decltype(kX3), 
+  decltype(kX4), decltype(kX5), decltype(kX6), decltype(kX7), decltype(kN0), decltype(kN1), 
+  decltype(kN2), decltype(kN3), decltype(kWeights), decltype(kS0), decltype(kS1), 
+  decltype(kS2)> WideArgs;
+
+[[gnu::noinline]] double wideArgs(const WideArgs& _args)
+{
+  return (_args[kX0] + _args[kX1] + _args[kX2] + _args[kX3] + _args[kX4] + _args[kX5] 
+    + _args[kX6] + _args[kX7]) * _args[kWeights][_args[kN0] % 4]
+    + (_args[kN0] + _args[kN1] + _args[kN2] + _args[kN3]) * _args.getOr(kS0, 1.0) 
+    + _args.getOr(kS1, 0.0) - _args.getOr(kS2, 0.0);
+}
+
+NAMEDPARAMS_PARAMETRIZE_ARGS(np_wideArgs, &wideArgs)
+
+int main()
+{
+  const std::vector<double> weights = {0.5, 1.0, 1.5, 2.0};
+
+  runBenchmark("direct", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return wide(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, _i, 1, 2, 3, weights, 2.0, std::nullopt, 
+      0.5);
+  });
+
+  runBenchmark("KeyFunction named", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return np_wide(kS2 = 0.5, kWeights = weights, kN3 = 3, kN2 = 2, kN1 = 1, kN0 = _i, 
+      kX7 = 8.0, kX6 = 7.0, kX5 = 6.0, kX4 = 5.0, kX3 = 4.0, kX2 = 3.0, kX1 = 2.0, kX0 = 1.0, 
+      kS0 = 2.0);
+  });
+
+  runBenchmark("KeyArgsFunction named", BENCHMARK_NB_CALLS, [&](int _i)
+  {
+    return np_wideArgs(kS2 = 0.5, kWeights = weights, kN3 = 3, kN2 = 2, kN1 = 1, kN0 = _i, 
+      kX7 = 8.0, kX6 = 7.0, kX5 = 6.0, kX4 = 5.0, kX3 = 4.0, kX2 = 3.0, kX1 = 2.0, kX0 = 1.0, 
+      kS0 = 2.0);
+  });
+
+  return 0;
+}
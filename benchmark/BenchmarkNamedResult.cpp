@@ -0,0 +1,93 @@
+#include "NamedParams.h"
+#include "BenchmarkRun.h"
+
+#include <vector>
+
+// compares returning multiple values through reference keys (out-parameters) with returning
+// a NamedResult, for direct calls and calls through a KeyFunction
+
+#ifndef BENCHMARK_NB_CALLS
+#define BENCHMARK_NB_CALLS 10000000
+#endif
+
+[[gnu::noinline]] void rangeOut(const std::vector<double>& _values, size_t _offset,
+  double& _min, double& _max, size_t& _argMin)
+{
+  _min = _values[_offset];
+  _max = _values[_offset];
+  _argMin = _offset;
+  for (size_t i = _offset + 1; i < _offset + 4; ++i)
+  {
+    if (_values[i] < _min)
+    {
+      _min = _values[i];
+      _argMin = i;
+    }
+    _max = (_values[i] > _max) ? _values[i] : _max;
+  }
+}
+
+#define RANGE_OUT_VARS (kValues, kOffset, kMinOut, kMaxOut, kArgMinOut)
+NAMEDPARAMS_PARAMETRIZE(np_rangeOut, &rangeOut, RANGE_OUT_VARS)
+
+NAMEDPARAMS_RESULT(Range, ((kMin, double), (kMax, double), (kArgMin, size_t)))
+
+[[gnu::noinline]] Range range(const std::vector<double>& _values, size_t _offset)
+{
+  double min = _values[_offset];
+  double max = _values[_offset];
+  size_t argMin = _offset;
+  for (size_t i = _offset + 1; i < _offset + 4; ++i)
+  {
+    if (_values[i] < min)
+    {
+      min = _values[i];
+      argMin = i;
+    }
+    max = (_values[i] > max) ? _values[i] : max;
+  }
+  return {kMin = min, kMax = max, kArgMin = argMin};
+}
+
+#define RANGE_VARS (kRangeValues, kRangeOffset)
+NAMEDPARAMS_PARAMETRIZE(np_range, &range, RANGE_VARS)
+
+int main()
+{
+  std::vector<double> values(64);
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = double((i * 37) % 64) - 20.0;
+  }
+
+  runBenchmark("out-parameters", BENCHMARK_NB_CALLS, [&](size_t _offset)
+  {
+    double min, max;
+    size_t argMin;
+    rangeOut(values, _offset, min, max, argMin);
+    return min + max + argMin;
+  });
+
+  runBenchmark("NamedResult", BENCHMARK_NB_CALLS, [&](size_t _offset)
+  {
+    Range result = range(values, _offset);
+    return result[kMin] + result[kMax] + result[kArgMin];
+  });
+
+  runBenchmark("KeyFunction out-parameters", BENCHMARK_NB_CALLS, [&](size_t _offset)
+  {
+    double min, max;
+    size_t argMin;
+    np_rangeOut(kOffset = _offset, kValues = values, kMinOut = min, kMaxOut = max,
+      kArgMinOut = argMin);
+    return min + max + argMin;
+  });
+
+  runBenchmark("KeyFunction NamedResult", BENCHMARK_NB_CALLS, [&](size_t _offset)
+  {
+    auto [min, max, argMin] = np_range(kRangeOffset = _offset, kRangeValues = values);
+    return min + max + argMin;
+  });
+
+  return 0;
+}
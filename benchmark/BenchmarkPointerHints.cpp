@@ -0,0 +1,74 @@
+#include "NamedParams.h"
+#include "BenchmarkRun.h"
+
+#include <iostream>
+#include <memory>
+#include <new>
+
+// an axpy kernel (y += a * x) called through pointer keys, with raw pointers and with
+// NamedParams::aligned and NamedParams::noalias hints
+
+#ifndef BENCHMARK_SIZE
+#define BENCHMARK_SIZE 1000
+#endif
+
+#ifndef BENCHMARK_NB_CALLS
+#define BENCHMARK_NB_CALLS 1000000
+#endif
+
+[[gnu::noinline]] void axpy(double _a, const double* _x, double* _y, size_t _size)
+{
+  for (size_t i = 0; i < _size; ++i)
+  {
+    _y[i] += _a * _x[i];
+  }
+}
+
+#define AXPY_VARS (kA, kX, kY, kSize)
+NAMEDPARAMS_PARAMETRIZE(np_axpy, &axpy, AXPY_VARS)
+
+[[gnu::noinline]] void axpyHinted(double _a, NamedParams::AlignedPtr<const double,64> _x, 
+  NamedParams::NoAliasPtr<double,64> _y, size_t _size)
+{
+  const double* NAMEDPARAMS_RESTRICT x = _x.get();
+  double* NAMEDPARAMS_RESTRICT y = _y.get();
+  for (size_t i = 0; i < _size; ++i)
+  {
+    y[i] += _a * x[i];
+  }
+}
+
+// the keys of hinted pointers have the hinted types
+#define AXPY_HINTED_VARS (kHintedA, kHintedX, kHintedY, kHintedSize)
+NAMEDPARAMS_PARAMETRIZE(np_axpyHinted, &axpyHinted, AXPY_HINTED_VARS)
+
+int main()
+{
+  const std::align_val_t alignment{64};
+  double* x = static_cast<double*>(::operator new(BENCHMARK_SIZE * sizeof(double), alignment));
+  double* y = static_cast<double*>(::operator new(BENCHMARK_SIZE * sizeof(double), alignment));
+  for (size_t i = 0; i < BENCHMARK_SIZE; ++i)
+  {
+    x[i] = 1.0 / (i + 1);
+    y[i] = 0.0;
+  }
+  const double a = 1e-6;
+
+  runBenchmark("raw pointers", BENCHMARK_NB_CALLS, [&]()
+  {
+    np_axpy(kA = a, kX = x, kY = y, kSize = size_t(BENCHMARK_SIZE));
+  });
+
+  runBenchmark("aligned and noalias", BENCHMARK_NB_CALLS, [&]()
+  {
+    np_axpyHinted(kHintedA = a, kHintedX = NamedParams::aligned<64>(static_cast<const double*>(x)),
+      kHintedY = NamedParams::noalias(NamedParams::aligned<64>(y)), 
+      kHintedSize = size_t(BENCHMARK_SIZE));
+  });
+
+  std::cout << "(checksum " << y[BENCHMARK_SIZE - 1] << ")" << std::endl;
+
+  ::operator delete(x, alignment);
+  ::operator delete(y, alignment);
+  return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef BENCHMARK_RUN_H
+#define BENCHMARK_RUN_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+// timing loop shared by the runtime benchmarks
+
+/// calls _function _nbCalls times and prints the time per call, or per unit if each call
+/// processes _nbUnitsPerCall units (e.g. rows). _function takes no argument, or a value in
+/// [0, 60) which changes from call to call, so the calls cannot be hoisted out of the loop.
+/// Results are summed into a checksum, which is printed so the calls are not optimized away
+template <class TFunction>
+void runBenchmark(const char* _name, size_t _nbCalls, TFunction&& _function,
+  size_t _nbUnitsPerCall = 1, const char* _unit = "call")
+{
+  constexpr bool takesArgument = std::is_invocable<TFunction&, size_t>::value;
+  typedef typename std::conditional<takesArgument, std::invoke_result<TFunction&, size_t>,
+    std::invoke_result<TFunction&>>::type::type ResultType;
+  constexpr bool hasResult = !std::is_void<ResultType>::value;
+
+  double checksum = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < _nbCalls; ++i)
+  {
+    if constexpr (takesArgument && hasResult)
+    {
+      checksum += _function(i % 60);
+    }
+    else if constexpr (takesArgument)
+    {
+      _function(i % 60);
+    }
+    else if constexpr (hasResult)
+    {
+      checksum += _function();
+    }
+    else
+    {
+      _function();
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double,std::nano> elapsed = end - start;
+  std::cout << _name << ": " << elapsed.count() / (double(_nbCalls) * _nbUnitsPerCall)
+    << " ns/" << _unit;
+  if constexpr (hasResult)
+  {
+    std::cout << " (checksum " << checksum << ")";
+  }
+  std::cout << std::endl;
+}
+
+#endif // BENCHMARK_RUN_H
@@ -0,0 +1,24 @@
+#ifndef COMPILE_TIME_SHARED_H
+#define COMPILE_TIME_SHARED_H
+
+#include "NamedParams.h"
+#include <string>
+
+// function shared by all translation units of the compile-time benchmark
+
+double sharedCompute(int _method, double _threshold, std::optional<int> _maxIter,
+                     std::optional<int> _nbBatches, std::optional<double> _scaling,
+                     std::optional<bool> _doDiis, std::optional<std::string> _guess,
+                     std::optional<double> _orthoThreshold);
+
+#define SHARED_COMPUTE_VARS (kMethod, kThreshold, kMaxIter, kNbBatches, kScaling, kDoDiis, kGuess, \
+                             kOrthoThreshold)
+NAMEDPARAMS_PARAMETRIZE(np_sharedCompute, &sharedCompute, SHARED_COMPUTE_VARS)
+
+#ifdef COMPILE_BENCHMARK_DECLARE_CALLS
+NAMEDPARAMS_DECLARE_CALL(np_sharedCompute, (kThreshold, kMethod, kScaling))
+NAMEDPARAMS_DECLARE_CALL(np_sharedCompute, (kGuess, kMethod, kThreshold, kNbBatches, kDoDiis))
+NAMEDPARAMS_DECLARE_CALL(np_sharedCompute, (kOrthoThreshold, kMaxIter, kThreshold, kMethod))
+#endif
+
+#endif // COMPILE_TIME_SHARED_H
@@ -0,0 +1,19 @@
+#include "CompileTimeShared.h"
+
+// the only translation unit of the compile-time benchmark which instantiates the shared calls
+
+double sharedCompute(int _method, double _threshold, std::optional<int> _maxIter,
+                     std::optional<int> _nbBatches, std::optional<double> _scaling,
+                     std::optional<bool> _doDiis, std::optional<std::string> _guess,
+                     std::optional<double> _orthoThreshold)
+{
+  return _method * _threshold + _maxIter.value_or(0) + _nbBatches.value_or(0) 
+    + _scaling.value_or(0.0) + _doDiis.value_or(false) + (_guess ? _guess->size() : 0)
+    + _orthoThreshold.value_or(0.0);
+}
+
+#ifdef COMPILE_BENCHMARK_DECLARE_CALLS
+NAMEDPARAMS_INSTANTIATE_CALL(np_sharedCompute, (kThreshold, kMethod, kScaling))
+NAMEDPARAMS_INSTANTIATE_CALL(np_sharedCompute, (kGuess, kMethod, kThreshold, kNbBatches, kDoDiis))
+NAMEDPARAMS_INSTANTIATE_CALL(np_sharedCompute, (kOrthoThreshold, kMaxIter, kThreshold, kMethod))
+#endif
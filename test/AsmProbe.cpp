@@ -0,0 +1,80 @@
+// probes for the TestAsmEquivalence target: each named call through a KeyFunction is compiled
+// next to the equivalent direct call, and the disassembly of both is compared.
+// The functions are only declared, so the calls are not inlined.
+#include "../NamedParams.h"
+
+int sum(int _a, const int _b, std::optional<int> _c, std::optional<int> _d, std::optional<int> _e);
+
+#define SUM_VARS (keyA, keyB, keyC, keyD, keyE)
+NAMEDPARAMS_PARAMETRIZE(np_sum, &sum, SUM_VARS)
+
+using intOpt = std::optional<int>;
+
+int manyArgs(int i0, int i1, int i2, int i3, int i4, int i5, int i6, int i7, int i8, int i9,
+             intOpt i10, intOpt i11, intOpt i12, intOpt i13, intOpt i14, intOpt i15, intOpt i16, 
+             intOpt i17, intOpt i18, intOpt i19);
+
+#define MANY_ARGS_VARS (keyI0, keyI1, keyI2, keyI3, keyI4, keyI5, keyI6, keyI7, keyI8, keyI9,\
+                        keyI10, keyI11, keyI12, keyI13, keyI14, keyI15, keyI16, keyI17, keyI18,\
+                        keyI19)
+
+NAMEDPARAMS_PARAMETRIZE(np_manyArgs, &manyArgs, MANY_ARGS_VARS)
+
+class Test
+{
+  public:
+
+    int compute(int _a, int _b, float& _c, std::optional<int> _d) const;
+
+    #define COMPUTE_LIST (paramA, paramB, paramC, paramD)
+    NAMEDPARAMS_CLASS_PARAMETRIZE(np_compute, &Test::compute, COMPUTE_LIST)
+
+    Test()
+      : NAMEDPARAMS_INIT_CLASS_FUNCTION(np_compute, &Test::compute, COMPUTE_LIST)
+    {
+    }
+};
+
+// np_compute calls the instance it was initialized with, through the pointer it stores. 
+// The equivalent direct call goes through a stored instance pointer as well
+struct TestPointer
+{
+  const Test* instance;
+};
+
+extern "C" 
+{
+
+int probe_named_sum(int _a, int _b, int _d)
+{
+  return np_sum(keyD = _d, keyA = _a, keyB = _b);
+}
+
+int probe_direct_sum(int _a, int _b, int _d)
+{
+  return sum(_a, _b, std::nullopt, _d, std::nullopt);
+}
+
+int probe_named_manyArgs(int _i)
+{
+  return np_manyArgs(keyI5 = 5, keyI0 = _i, keyI1 = 1, keyI2 = 2, keyI6 = 6, keyI7 = 7, 
+                     keyI15 = _i, keyI10 = _i, keyI3 = 3, keyI9 = 9, keyI8 = 8, keyI4 = 4);
+}
+
+int probe_direct_manyArgs(int _i)
+{
+  return manyArgs(_i, 1, 2, 3, 4, 5, 6, 7, 8, 9, _i, std::nullopt, std::nullopt, std::nullopt, 
+                  std::nullopt, _i, std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+}
+
+int probe_named_compute(const Test& _test, float& _c, int _d)
+{
+  return _test.np_compute(1, 2, Test::paramD = _d, Test::paramC = _c);
+}
+
+int probe_direct_compute(const TestPointer& _test, float& _c, int _d)
+{
+  return _test.instance->compute(1, 2, _c, _d);
+}
+
+}
@@ -0,0 +1,56 @@
+// probe for the TestCodeSize target: calls np_probeWord with NAMEDPARAMS_PROBE_PERMUTATIONS
+// different orders of the same named parameters, so the .text size of the object files
+// compiled with a different number of permutations shows the cost of each additional one
+#include "../NamedParams.h"
+#include <string>
+
+#ifndef NAMEDPARAMS_PROBE_PERMUTATIONS
+#define NAMEDPARAMS_PROBE_PERMUTATIONS 1
+#endif
+
+[[gnu::noinline]] std::string probeWord(char _a, char _b, char _c, char _d, std::optional<int> _repeat)
+{
+  std::string out = {_a, _b, _c, _d};
+  for (int i = 1; i < _repeat.value_or(1); ++i)
+  {
+    out += out;
+  }
+  return out;
+}
+
+NAMEDPARAMS_PARAMETRIZE(np_probeWord, &probeWord, (probe0, probe1, probe2, probe3, probeRepeat))
+
+#if NAMEDPARAMS_PROBE_PERMUTATIONS > 0
+std::string probePermutation0(char _c) 
+{ 
+  return np_probeWord(probe0 = _c, probe1 = 'b', probe2 = 'c', probe3 = 'd'); 
+}
+#endif
+
+#if NAMEDPARAMS_PROBE_PERMUTATIONS > 1
+std::string probePermutation1(char _c) 
+{ 
+  return np_probeWord(probe1 = 'b', probe0 = _c, probe2 = 'c', probe3 = 'd'); 
+}
+#endif
+
+#if NAMEDPARAMS_PROBE_PERMUTATIONS > 2
+std::string probePermutation2(char _c) 
+{ 
+  return np_probeWord(probe2 = 'c', probe1 = 'b', probe0 = _c, probe3 = 'd'); 
+}
+#endif
+
+#if NAMEDPARAMS_PROBE_PERMUTATIONS > 3
+std::string probePermutation3(char _c) 
+{ 
+  return np_probeWord(probe3 = 'd', probe2 = 'c', probe1 = 'b', probe0 = _c); 
+}
+#endif
+
+#if NAMEDPARAMS_PROBE_PERMUTATIONS > 4
+std::string probePermutation4(char _c) 
+{ 
+  return np_probeWord(probe1 = 'b', probe3 = 'd', probe0 = _c, probe2 = 'c'); 
+}
+#endif
@@ -0,0 +1,14 @@
+// probe for the TestDeclaredCallSymbols target: calls which match the signatures declared in
+// TestDeclaredCall.h only through DeclaredArgument. Each has to refer to the explicitly 
+// instantiated callDeclared, so the object may not define any callDeclared itself
+#include "TestDeclaredCall.h"
+
+std::string probeTemporary(const std::string& _a)
+{
+  return np_join(keyB = std::string("b"), keyA = _a);
+}
+
+int probeConstant(int _value)
+{
+  return np_scale(keyValue = _value, keyFactor = NamedParams::constant<2>);
+}
@@ -0,0 +1,83 @@
+# Compares the disassembly of named calls through a KeyFunction with the equivalent direct calls.
+# Called by ctest with
+#   OBJDUMP_PROGRAM: binutils objdump
+#   PROBE: object file compiled from test/AsmProbe.cpp
+# For each pair probe_named_<name>/probe_direct_<name>, the named version fails if it has more
+# instructions than the direct one, calls operator new, or keeps an indirect call.
+
+execute_process(COMMAND ${OBJDUMP_PROGRAM} -dr --no-show-raw-insn -C ${PROBE}
+  OUTPUT_VARIABLE DISASSEMBLY RESULT_VARIABLE OBJDUMP_RESULT)
+if (NOT OBJDUMP_RESULT EQUAL 0)
+  message(FATAL_ERROR "Could not run ${OBJDUMP_PROGRAM} on ${PROBE}")
+endif()
+
+# semicolons would split the lines into list elements
+string(REPLACE ";" "," DISASSEMBLY "${DISASSEMBLY}")
+string(REPLACE "\n" ";" DISASSEMBLY_LINES "${DISASSEMBLY}")
+
+set(PROBE_NAMES)
+set(CURRENT_PROBE "")
+foreach(LINE ${DISASSEMBLY_LINES})
+  if (LINE MATCHES "^[0-9a-f]+ <(probe_[a-z]+_[A-Za-z0-9]+)>:")
+    set(CURRENT_PROBE ${CMAKE_MATCH_1})
+    list(APPEND PROBE_NAMES ${CURRENT_PROBE})
+    set(NB_INSTRUCTIONS_${CURRENT_PROBE} 0)
+    set(ERRORS_${CURRENT_PROBE} "")
+  elseif (LINE MATCHES "^[0-9a-f]+ <")
+    set(CURRENT_PROBE "")
+  elseif (CURRENT_PROBE STREQUAL "")
+    continue()
+  elseif (LINE MATCHES "^[ \t]+[0-9a-f]+:[ \t]+R_[A-Z0-9_]+[ \t]+(.*)$")
+    # relocation of the previous instruction, i.e. the callee of a direct call
+    if (CMAKE_MATCH_1 MATCHES "operator new|_Znwm|_Znam")
+      string(APPEND ERRORS_${CURRENT_PROBE} " calls operator new,")
+    endif()
+  elseif (LINE MATCHES "^[ \t]+[0-9a-f]+:[ \t]+(.*)$")
+    set(INSTRUCTION "${CMAKE_MATCH_1}")
+    # alignment padding between functions
+    if (INSTRUCTION MATCHES "^(nop|xchg +%ax,%ax|int3|data16|cs nop)")
+      continue()
+    endif()
+    math(EXPR NB_INSTRUCTIONS_${CURRENT_PROBE} "${NB_INSTRUCTIONS_${CURRENT_PROBE}} + 1")
+    # x86 "call *%rax", "jmp *0x0(%rip)", aarch64 "blr x1", "br x1"
+    if (INSTRUCTION MATCHES "^(call|jmp)[a-z]*[ \t]+\\*" OR INSTRUCTION MATCHES "^(blr|br)[ \t]")
+      string(APPEND ERRORS_${CURRENT_PROBE} " indirect call '${INSTRUCTION}',")
+    endif()
+  endif()
+endforeach()
+
+set(NB_COMPARED 0)
+set(FAILED FALSE)
+foreach(PROBE_NAME ${PROBE_NAMES})
+  if (NOT PROBE_NAME MATCHES "^probe_named_(.*)$")
+    continue()
+  endif()
+  set(NAME ${CMAKE_MATCH_1})
+  set(NAMED probe_named_${NAME})
+  set(DIRECT probe_direct_${NAME})
+
+  if (NOT DEFINED NB_INSTRUCTIONS_${DIRECT})
+    message(FATAL_ERROR "${DIRECT} not found in ${PROBE}")
+  endif()
+
+  message("${NAME}: named ${NB_INSTRUCTIONS_${NAMED}} instructions, "
+    "direct ${NB_INSTRUCTIONS_${DIRECT}}")
+
+  if (NB_INSTRUCTIONS_${NAMED} GREATER NB_INSTRUCTIONS_${DIRECT})
+    string(APPEND ERRORS_${NAMED} " more instructions than ${DIRECT},")
+  endif()
+
+  if (NOT ERRORS_${NAMED} STREQUAL "")
+    message("${NAMED}:${ERRORS_${NAMED}}")
+    set(FAILED TRUE)
+  endif()
+  math(EXPR NB_COMPARED "${NB_COMPARED} + 1")
+endforeach()
+
+if (NB_COMPARED EQUAL 0)
+  message(FATAL_ERROR "No probes found in ${PROBE}")
+endif()
+
+if (FAILED)
+  message(FATAL_ERROR "Named calls are not equivalent to direct calls")
+endif()
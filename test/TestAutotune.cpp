@@ -0,0 +1,127 @@
+#include "../NamedParamsAutotune.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+int nbCalls = 0;
+
+/// returns the block size it was called with. Block sizes far from the best one for the
+/// problem size are slow
+int multiply(const std::vector<double>& _matrix, std::optional<int> _blockSize,
+  std::optional<int> _nbBatches)
+{
+  ++nbCalls;
+  const int blockSize = _blockSize.value_or(1);
+  const int best = static_cast<int>(_matrix.size()) / 2;
+  const int distance = std::abs(blockSize - best) + std::abs(_nbBatches.value_or(1) - 2);
+  std::this_thread::sleep_for(std::chrono::microseconds(500 * distance));
+  return blockSize * 100 + _nbBatches.value_or(1);
+}
+
+#define MULTIPLY_VARS (kMatrix, kBlockSize, kNbBatches)
+NAMEDPARAMS_PARAMETRIZE(np_multiply, &multiply, MULTIPLY_VARS)
+
+/// same keys as multiply, the best block size is a quarter of the problem size
+int multiplyWide(const std::vector<double>& _matrix, std::optional<int> _blockSize,
+  std::optional<int> _nbBatches)
+{
+  const int blockSize = _blockSize.value_or(1);
+  const int best = static_cast<int>(_matrix.size()) / 4;
+  std::this_thread::sleep_for(std::chrono::microseconds(500 * std::abs(blockSize - best)));
+  return blockSize * 100 + _nbBatches.value_or(1);
+}
+
+constexpr inline NamedParams::KeyFunction np_multiplyWide(
+  NamedParams::FunctionConstant<&multiplyWide>{}, kMatrix, kBlockSize, kNbBatches);
+
+int main()
+{
+  int result = 0;
+
+  const std::string filename = "TestAutotune.cache";
+  std::remove(filename.c_str());
+
+  const std::vector<double> small(16);
+  const std::vector<double> large(64);
+
+  {
+    NamedParams::Autotuner tuner("multiply", np_multiply, filename, kBlockSize = {4, 8, 16, 32},
+      kNbBatches = {1, 2, 4});
+
+    // without tuning, the defaults of the function are used
+    CHECK_EQUAL(tuner(small.size(), kMatrix = small), 101, result);
+    CHECK_EQUAL(tuner.getConfiguration(small.size()).has_value(), false, result);
+
+    nbCalls = 0;
+    auto configuration = tuner.tune(small.size(), 2, kMatrix = small);
+    CHECK_EQUAL(nbCalls, 4 * 3 * 2, result);
+    CHECK_EQUAL(configuration.indices[0], 1u, result);
+    CHECK_EQUAL(configuration.indices[1], 1u, result);
+
+    tuner.tune(large.size(), 1, kMatrix = large);
+
+    CHECK_EQUAL(tuner(small.size(), kMatrix = small), 802, result);
+    CHECK_EQUAL(tuner(large.size(), kMatrix = large), 3202, result);
+
+    // passed keys are not replaced by tuned values
+    CHECK_EQUAL(tuner(small.size(), small, kNbBatches = 7), 807, result);
+    CHECK_EQUAL(tuner(small.size(), kBlockSize = 3, kMatrix = small), 302, result);
+  }
+
+  {
+    // the configurations are read from the cache
+    NamedParams::Autotuner tuner("multiply", np_multiply, filename, kBlockSize = {4, 8, 16, 32},
+      kNbBatches = {1, 2, 4});
+    nbCalls = 0;
+    CHECK_EQUAL(tuner(small.size(), kMatrix = small), 802, result);
+    CHECK_EQUAL(tuner(large.size(), kMatrix = large), 3202, result);
+    CHECK_EQUAL(nbCalls, 2, result);
+  }
+
+  {
+    // different candidates do not use the cached configurations
+    NamedParams::Autotuner tuner("multiply", np_multiply, filename, kBlockSize = {8, 16});
+    CHECK_EQUAL(tuner.getConfiguration(small.size()).has_value(), false, result);
+    CHECK_EQUAL(tuner(small.size(), kMatrix = small), 101, result);
+  }
+
+  {
+    // disengaged candidates match regardless of the bytes left in their storage
+    std::optional<int> stale = 5;
+    stale.reset();
+    NamedParams::Autotuner staleTuner("multiply", np_multiply, filename, kBlockSize = {stale, 8});
+    staleTuner.tune(small.size(), 1, kMatrix = small);
+
+    NamedParams::Autotuner tuner("multiply", np_multiply, filename, 
+      kBlockSize = {std::optional<int>(), 8});
+    CHECK_EQUAL(tuner.getConfiguration(small.size()).has_value(), true, result);
+  }
+
+  {
+    // functions with the same keys keep their own configurations in a shared cache
+    NamedParams::Autotuner tuner("multiply", np_multiply, filename, kBlockSize = {4, 8});
+    NamedParams::Autotuner wideTuner("multiplyWide", np_multiplyWide, filename, 
+      kBlockSize = {4, 8});
+    tuner.tune(small.size(), 1, kMatrix = small);
+    wideTuner.tune(small.size(), 1, kMatrix = small);
+
+    NamedParams::Autotuner cachedTuner("multiply", np_multiply, filename, kBlockSize = {4, 8});
+    NamedParams::Autotuner cachedWideTuner("multiplyWide", np_multiplyWide, filename, 
+      kBlockSize = {4, 8});
+    CHECK_EQUAL(cachedTuner(small.size(), kMatrix = small), 801, result);
+    CHECK_EQUAL(cachedWideTuner(small.size(), kMatrix = small), 401, result);
+  }
+
+  std::remove(filename.c_str());
+
+  return result;
+}
@@ -0,0 +1,126 @@
+#include "../NamedParamsCallLog.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+struct Point
+{
+  double x;
+  double y;
+};
+
+double checksum = 0;
+
+double evaluate(int _order, const Point& _point, std::optional<double> _scaling,
+  NamedParams::OptRef<const int> _offset)
+{
+  double value = _order * (_point.x + 2 * _point.y) * _scaling.value_or(1.0)
+    + (_offset ? *_offset : 0);
+  checksum += value;
+  return value;
+}
+
+#define EVALUATE_VARS (kOrder, kPoint, kScaling, kOffset)
+NAMEDPARAMS_PARAMETRIZE(np_evaluate, &evaluate, EVALUATE_VARS)
+
+int negate(int _i)
+{
+  return -_i;
+}
+
+#define NEGATE_VARS (kNegateI)
+NAMEDPARAMS_PARAMETRIZE(np_negate, &negate, NEGATE_VARS)
+
+int main()
+{
+  int result = 0;
+
+  const std::string filename = "TestCallLog.nplog";
+  const Point point = {1.0, 2.0};
+  const int offset = 3;
+
+  {
+    // small buffer, so the log is written in several chunks
+    NamedParams::CallRecorder recorder(np_evaluate, filename, 64);
+
+    for (int i = 0; i < 100; ++i)
+    {
+      recorder(kPoint = point, kOrder = i);
+      recorder(i, point, kOffset = offset);
+      recorder(kScaling = 0.5, kOrder = i, kPoint = Point{double(i), 1.0});
+    }
+
+    CHECK_EQUAL(recorder.getNbCalls(), 300u, result);
+  }
+
+  const double recordedChecksum = checksum;
+  checksum = 0;
+
+  NamedParams::CallLogReader reader(filename);
+
+  // header with key IDs and sizes, then mask, order, point, and the present optionals
+  const size_t expectedSize = sizeof(NamedParams::CallLogHeader) 
+    + 4 * (sizeof(int64_t) + sizeof(uint32_t))
+    + 300 * (sizeof(uint64_t) + sizeof(int) + sizeof(Point))
+    + 100 * (sizeof(int) + sizeof(double));
+  CHECK_EQUAL(reader.getSize(), expectedSize, result);
+
+  CHECK_EQUAL(reader.replay(np_evaluate), 300u, result);
+  CHECK_EQUAL(checksum, recordedChecksum, result);
+
+  // replaying with a different function fails
+  bool hasThrown = false;
+  try
+  {
+    reader.replay(np_negate);
+  }
+  catch (const std::runtime_error&)
+  {
+    hasThrown = true;
+  }
+  CHECK_EQUAL(hasThrown, true, result);
+
+  // every thread records into its own buffer, the buffers are merged into one log
+  const std::string threadsFilename = "TestCallLogThreads.nplog";
+  {
+    NamedParams::CallRecorder recorder(np_negate, threadsFilename, 64);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+      threads.emplace_back([&recorder, t]()
+      {
+        for (int i = 0; i < 250; ++i)
+        {
+          recorder(kNegateI = t * 250 + i);
+        }
+      });
+    }
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+
+    recorder.flush();
+    CHECK_EQUAL(recorder.getNbCalls(), 1000u, result);
+  }
+
+  NamedParams::CallLogReader threadsReader(threadsFilename);
+  CHECK_EQUAL(threadsReader.getSize(), sizeof(NamedParams::CallLogHeader) 
+    + sizeof(int64_t) + sizeof(uint32_t) + 1000 * (sizeof(uint64_t) + sizeof(int)), result);
+  CHECK_EQUAL(threadsReader.replay(np_negate), 1000u, result);
+
+  std::remove(filename.c_str());
+  std::remove(threadsFilename.c_str());
+
+  return result;
+}
@@ -0,0 +1,52 @@
+# Reports the .text growth per additional call-site permutation of the same named parameters,
+# and fails if it is larger than MAX_PERMUTATION_SIZE.
+# Called by ctest with
+#   SIZE_PROGRAM, NM_PROGRAM: binutils size and nm
+#   NB_PERMUTATIONS: number of permutations in the last probe object
+#   OPTIMIZATION: name of the optimization level, only used for the report
+#   MAX_PERMUTATION_SIZE: largest allowed .text growth per additional permutation, in bytes
+#   PROBE_EMPTY, PROBE_SINGLE, PROBE_MULTIPLE: probe objects with 0, 1 and NB_PERMUTATIONS calls
+
+function(get_text_size OBJECT OUTPUT)
+  execute_process(COMMAND ${SIZE_PROGRAM} -A ${OBJECT}
+    OUTPUT_VARIABLE SIZE_OUTPUT RESULT_VARIABLE SIZE_RESULT)
+  if (NOT SIZE_RESULT EQUAL 0)
+    message(FATAL_ERROR "Could not run ${SIZE_PROGRAM} on ${OBJECT}")
+  endif()
+
+  # sum of all .text* sections, template instantiations are in their own .text.<name> section
+  set(TEXT_SIZE 0)
+  string(REPLACE "\n" ";" SIZE_LINES "${SIZE_OUTPUT}")
+  foreach(LINE ${SIZE_LINES})
+    if (LINE MATCHES "^\\.text[^ ]*[ ]+([0-9]+)")
+      math(EXPR TEXT_SIZE "${TEXT_SIZE} + ${CMAKE_MATCH_1}")
+    endif()
+  endforeach()
+
+  set(${OUTPUT} ${TEXT_SIZE} PARENT_SCOPE)
+endfunction()
+
+get_text_size(${PROBE_EMPTY} EMPTY_SIZE)
+get_text_size(${PROBE_SINGLE} SINGLE_SIZE)
+get_text_size(${PROBE_MULTIPLE} MULTIPLE_SIZE)
+
+math(EXPR FIRST_CALL_SIZE "${SINGLE_SIZE} - ${EMPTY_SIZE}")
+math(EXPR PERMUTATION_SIZE "(${MULTIPLE_SIZE} - ${SINGLE_SIZE}) / (${NB_PERMUTATIONS} - 1)")
+
+message("${OPTIMIZATION}: first call ${FIRST_CALL_SIZE} bytes, "
+  "each additional permutation ${PERMUTATION_SIZE} bytes of .text")
+
+if (PERMUTATION_SIZE GREATER MAX_PERMUTATION_SIZE)
+  message(FATAL_ERROR "Each additional permutation adds ${PERMUTATION_SIZE} bytes of .text, "
+    "the limit is ${MAX_PERMUTATION_SIZE} bytes")
+endif()
+
+# all permutations have to share a single instantiation of the call thunk. With optimizations
+# it is usually inlined into the call sites, so there is nothing to count
+execute_process(COMMAND ${NM_PROGRAM} -C ${PROBE_MULTIPLE} OUTPUT_VARIABLE NM_OUTPUT)
+string(REGEX MATCHALL "[^\n]*callCanonical[^\n]*" THUNKS "${NM_OUTPUT}")
+list(LENGTH THUNKS NB_THUNKS)
+
+if (NB_THUNKS GREATER 1)
+  message(FATAL_ERROR "${NB_THUNKS} call thunks for ${NB_PERMUTATIONS} permutations, expected 1")
+endif()
@@ -0,0 +1,112 @@
+#include "../NamedParamsColumns.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+struct Basis
+{
+  std::vector<double> exponents;
+};
+
+double energy(int _nbAtoms, std::optional<double> _scaling, const Basis& _basis, double _offset)
+{
+  double sum = 0;
+  for (double exponent : _basis.exponents)
+  {
+    sum += exponent;
+  }
+  return _nbAtoms * sum * _scaling.value_or(1.0) + _offset;
+}
+
+#define ENERGY_VARS (kNbAtoms, kScaling, kBasis, kOffset)
+NAMEDPARAMS_PARAMETRIZE(np_energy, &energy, ENERGY_VARS)
+
+int nbVisited = 0;
+int visitedAtoms = 0;
+
+void visit(int _nbAtoms)
+{
+  ++nbVisited;
+  visitedAtoms += _nbAtoms;
+}
+
+// reuses kNbAtoms, so the column is passed to np_visit
+constexpr inline NamedParams::KeyFunction np_visit(NamedParams::FunctionConstant<&visit>{},
+  kNbAtoms);
+
+int main()
+{
+  int result = 0;
+
+  NamedParams::NamedColumns<decltype(kNbAtoms), decltype(kScaling), decltype(kBasis)> columns;
+  CHECK_EQUAL(columns.size(), 0u, result);
+
+  // rows are appended like calls, absent optionals are std::nullopt
+  columns.pushBack(kNbAtoms = 2, kScaling = 0.5, kBasis = Basis{{1.0, 2.0}});
+  columns.pushBack(kBasis = Basis{{4.0}}, kNbAtoms = 3);
+  columns.pushBack(5, 2.0, Basis{{1.0}});
+  CHECK_EQUAL(columns.size(), 3u, result);
+
+  // columns are contiguous and aligned
+  CHECK_EQUAL(columns[kNbAtoms].size(), 3u, result);
+  CHECK_EQUAL(uintptr_t(columns[kNbAtoms].data()) % 64, 0u, result);
+  CHECK_EQUAL(uintptr_t(columns[kScaling].data()) % 64, 0u, result);
+  CHECK_EQUAL(columns[kNbAtoms][0], 2, result);
+  CHECK_EQUAL(columns[kNbAtoms][1], 3, result);
+  CHECK_EQUAL(columns[kNbAtoms][2], 5, result);
+  CHECK_EQUAL(columns[kScaling][0].value(), 0.5, result);
+  CHECK_EQUAL(columns[kScaling][1].has_value(), false, result);
+  CHECK_EQUAL(columns[kBasis][1].exponents[0], 4.0, result);
+
+  int sumAtoms = 0;
+  for (int nbAtoms : columns[kNbAtoms])
+  {
+    sumAtoms += nbAtoms;
+  }
+  CHECK_EQUAL(sumAtoms, 10, result);
+
+  // columns are passed by key, keys which are not columns are passed to every row
+  const std::vector<double> energies = columns.apply(np_energy, kOffset = 1.0);
+  CHECK_EQUAL(energies.size(), 3u, result);
+  CHECK_EQUAL(energies[0], 2 * 3.0 * 0.5 + 1.0, result);
+  CHECK_EQUAL(energies[1], 3 * 4.0 + 1.0, result);
+  CHECK_EQUAL(energies[2], 5 * 1.0 * 2.0 + 1.0, result);
+
+  // columns the function does not take are skipped, rows are visited in order
+  columns.apply(np_visit);
+  CHECK_EQUAL(nbVisited, 3, result);
+  CHECK_EQUAL(visitedAtoms, 10, result);
+
+  // columns can be written in place, and grow past their first allocation
+  columns[kScaling][1] = 2.0;
+  CHECK_EQUAL(columns.apply(np_energy, kOffset = 0.0)[1], 3 * 4.0 * 2.0, result);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    columns.pushBack(kNbAtoms = i, kBasis = Basis{});
+  }
+  CHECK_EQUAL(columns.size(), 103u, result);
+  CHECK_EQUAL(columns[kNbAtoms][102], 99, result);
+  CHECK_EQUAL(columns[kBasis][0].exponents.size(), 2u, result);
+  CHECK_EQUAL(uintptr_t(columns[kNbAtoms].data()) % 64, 0u, result);
+
+  // copies are deep
+  auto copy = columns;
+  copy[kNbAtoms][0] = 7;
+  CHECK_EQUAL(columns[kNbAtoms][0], 2, result);
+  CHECK_EQUAL(copy[kNbAtoms][0], 7, result);
+
+  columns.resize(1);
+  CHECK_EQUAL(columns.size(), 1u, result);
+  CHECK_EQUAL(columns[kBasis].size(), 1u, result);
+
+  return result;
+}
@@ -2,10 +2,19 @@
 
 #include <fstream>
 #include <iostream>
-#include <map>
+#include <vector>
 
 #cmakedefine OUTPUT_FILENAME "@OUTPUT_FILENAME@"
 
+// the compiler output of each case of ThisWillNotCompile.cpp starts with a line 
+// "@@ case <n>: <diagnostic>", and has to contain the diagnostic
+struct CompilationCase
+{
+  std::string name;
+  std::string diagnostic;
+  bool found;
+};
+
 int main()
 {
   int result = 0;
@@ -18,37 +27,42 @@ int main()
     return 1;
   }
 
-  std::map<const std::string,int> tokens = 
-  {
-    {"MISSING_KEY", 0},
-    {"INVALID_KEY", 0},
-    {"SAME_KEY_PASSED_MORE_THAN_ONCE", 0},
-    {"POSITIONAL_CANNOT_FOLLOW_KEY_ARGUMENT", 0},
-    {"TOO_MANY_ARGUMENTS_PASSED_TO_FUNCTION", 0},
-    {"COULD_NOT_CONVERT_KEY_TYPE_TO_ARGUMENT_TYPE", 0}
-    //{"KEY_HAS_WRONG_TYPE", 0}
-    //{"TOO_MANY_ARGUMENTS_PASSED_TO_KEYGEN", 0},
-    //{"SAME_KEY_PASSED_MORE_THAN_ONCE_KEYGEN", 0}
-  };
+  const std::string caseMarker = "@@ ";
+  std::vector<CompilationCase> cases;
 
   std::string line;
   while (std::getline(file, line))
   {
     std::cout << line << std::endl;
-    for (auto& pair : tokens)
+    if (line.compare(0, caseMarker.size(), caseMarker) == 0)
     {
-      if (line.find(pair.first) != std::string::npos)
+      size_t separator = line.find(": ");
+      if (separator == std::string::npos)
       {
-        ++pair.second;
+        std::cerr << "Invalid case line " << line << std::endl;
+        return 1;
       }
+      cases.push_back({line.substr(caseMarker.size(), separator - caseMarker.size()), 
+        line.substr(separator + 2), false});
+    }
+    else if (!cases.empty() && line.find(cases.back().diagnostic) != std::string::npos)
+    {
+      cases.back().found = true;
     }
   }
 
-  for (auto& pair : tokens)
+  if (cases.empty())
+  {
+    std::cerr << "No cases in " << OUTPUT_FILENAME << std::endl;
+    result++;
+  }
+
+  for (const CompilationCase& compilationCase : cases)
   {
-    if (pair.second == 0)
+    if (!compilationCase.found)
     {
-      std::cerr << "Could not find token " << pair.first << std::endl;
+      std::cerr << "Could not find " << compilationCase.diagnostic << " in the output of " 
+        << compilationCase.name << std::endl;
       result++;
     }
   }
@@ -57,4 +71,4 @@ int main()
 
   return result;
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,97 @@
+#include "../NamedParamsCoroutine.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+using NamedParams::Executor;
+using NamedParams::Task;
+
+/// counts copies, moves are free
+struct Tracked
+{
+  int value;
+
+  static inline int nbCopies = 0;
+
+  Tracked(int _value)
+    : value(_value)
+  {
+  }
+
+  Tracked(const Tracked& _other)
+    : value(_other.value)
+  {
+    ++nbCopies;
+  }
+
+  Tracked(Tracked&& _other) = default;
+};
+
+Task<int> accumulate(Executor& _executor, std::vector<int> _values, Tracked _scale,
+  std::optional<int> _offset, const std::string& _label)
+{
+  // the temporaries of the calling expression are gone after this
+  co_await _executor.schedule();
+
+  int sum = 0;
+  for (int value : _values)
+  {
+    sum += value * _scale.value;
+  }
+  co_return sum + _offset.value_or(0) + static_cast<int>(_label.size());
+}
+
+#define ACCUMULATE_VARS (kExecutor, kValues, kScale, kOffset, kLabel)
+NAMEDPARAMS_PARAMETRIZE(np_accumulate, &accumulate, ACCUMULATE_VARS)
+
+// braced lists like std::vector<int>{4} inside co_await expressions do not compile with GCC 12
+Task<int> total(Executor& _executor, const std::string& _label)
+{
+  int first = co_await np_accumulate(kLabel = _label, kExecutor = _executor,
+    kValues = std::vector<int>(3, 2), kScale = Tracked(1));
+  int second = co_await np_accumulate(_executor, std::vector<int>(1, 4), Tracked(10),
+    kOffset = first, kLabel = _label);
+  co_return first + second;
+}
+
+int main()
+{
+  int result = 0;
+
+  Executor executor;
+  const std::string label = "abc";
+
+  // by-value arguments are temporaries of this full-expression
+  Task<int> named = np_accumulate(kValues = std::vector<int>{1, 2, 3, 4}, kScale = Tracked(2),
+    kExecutor = executor, kLabel = label, kOffset = 100);
+  Task<int> positional = np_accumulate(executor, std::vector<int>{5}, Tracked(3),
+    std::nullopt, label);
+
+  CHECK_EQUAL(named.isDone(), false, result);
+
+  executor.spawn(named);
+  executor.spawn(positional);
+  executor.run();
+
+  CHECK_EQUAL(named.isDone(), true, result);
+  CHECK_EQUAL(named.getResult(), 2 * 10 + 100 + 3, result);
+  CHECK_EQUAL(positional.getResult(), 15 + 3, result);
+
+  // named calls awaited in another coroutine
+  Task<int> nested = total(executor, label);
+  executor.spawn(nested);
+  executor.run();
+  CHECK_EQUAL(nested.getResult(), 9 + (40 + 9 + 3), result);
+
+  // the by-value arguments are moved into the coroutine frames
+  CHECK_EQUAL(Tracked::nbCopies, 0, result);
+
+  return result;
+}
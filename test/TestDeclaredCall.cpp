@@ -0,0 +1,31 @@
+#include "TestDeclaredCall.h"
+#include <iostream>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  } 
+
+int main()
+{
+  int result = 0;
+
+  std::string a = "a";
+  std::string b = "b";
+
+  // declared signatures, instantiated in TestDeclaredCallInstantiation.cpp
+  CHECK_EQUAL(np_join(keyB = b, keyA = a), "ab", result);
+  CHECK_EQUAL(np_join(keyDelim = "-", keyA = a, keyB = b), "a-b", result);
+
+  // temporaries and compile-time constants use the same declarations, see DeclaredCallProbe.cpp
+  CHECK_EQUAL(np_join(keyB = std::string("b"), keyA = a), "ab", result);
+  CHECK_EQUAL(np_scale(keyValue = 3, keyFactor = NamedParams::constant<2>), 6, result);
+
+  // other signatures are still instantiated here
+  CHECK_EQUAL(np_join(keyA = a, keyB = b), "ab", result);
+  CHECK_EQUAL(np_join(a, b, keyDelim = "+"), "a+b", result);
+
+  return result;
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_DECLARED_CALL_H
+#define TEST_DECLARED_CALL_H
+
+#include "../NamedParams.h"
+#include <string>
+
+std::string join(const std::string& _a, const std::string& _b, std::optional<std::string> _delim);
+
+#define JOIN_VARS (keyA, keyB, keyDelim)
+NAMEDPARAMS_PARAMETRIZE(np_join, &join, JOIN_VARS)
+
+NAMEDPARAMS_DECLARE_CALL(np_join, (keyB, keyA))
+NAMEDPARAMS_DECLARE_CALL(np_join, (keyDelim, keyA, keyB))
+
+int scale(int _value, std::optional<int> _factor);
+
+#define SCALE_VARS (keyValue, keyFactor)
+NAMEDPARAMS_PARAMETRIZE(np_scale, &scale, SCALE_VARS)
+
+NAMEDPARAMS_DECLARE_CALL(np_scale, (keyValue, keyFactor))
+
+#endif // TEST_DECLARED_CALL_H
@@ -0,0 +1,15 @@
+#include "TestDeclaredCall.h"
+
+std::string join(const std::string& _a, const std::string& _b, std::optional<std::string> _delim)
+{
+  return _a + (_delim ? *_delim : "") + _b;
+}
+
+int scale(int _value, std::optional<int> _factor)
+{
+  return _value * _factor.value_or(1);
+}
+
+NAMEDPARAMS_INSTANTIATE_CALL(np_join, (keyB, keyA))
+NAMEDPARAMS_INSTANTIATE_CALL(np_join, (keyDelim, keyA, keyB))
+NAMEDPARAMS_INSTANTIATE_CALL(np_scale, (keyValue, keyFactor))
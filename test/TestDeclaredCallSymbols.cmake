@@ -0,0 +1,26 @@
+# Checks that calls matching a declared signature use the explicitly instantiated function.
+# Called by ctest with
+#   NM_PROGRAM: binutils nm
+#   PROBE: object file of test/DeclaredCallProbe.cpp
+#   NB_DECLARED: number of different declared signatures called by the probe
+
+execute_process(COMMAND ${NM_PROGRAM} -C ${PROBE} 
+  OUTPUT_VARIABLE NM_OUTPUT RESULT_VARIABLE NM_RESULT)
+if (NOT NM_RESULT EQUAL 0)
+  message(FATAL_ERROR "Could not run ${NM_PROGRAM} on ${PROBE}")
+endif()
+
+string(REGEX MATCHALL "[^\n]*callDeclared[^\n]*" SYMBOLS "${NM_OUTPUT}")
+
+set(NB_UNDEFINED 0)
+foreach(SYMBOL ${SYMBOLS})
+  if (SYMBOL MATCHES "^[ ]+U ")
+    math(EXPR NB_UNDEFINED "${NB_UNDEFINED} + 1")
+  else()
+    message(FATAL_ERROR "callDeclared is instantiated in the probe: ${SYMBOL}")
+  endif()
+endforeach()
+
+if (NOT NB_UNDEFINED EQUAL NB_DECLARED)
+  message(FATAL_ERROR "${NB_UNDEFINED} calls of declared signatures, expected ${NB_DECLARED}")
+endif()
@@ -0,0 +1,172 @@
+#include "../NamedParamsGraph.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+// counts copies, moves of intermediates are free
+struct Basis
+{
+  std::vector<double> exponents;
+
+  static inline std::atomic<int> nbCopies = 0;
+
+  Basis() = default;
+
+  explicit Basis(std::vector<double> _exponents)
+    : exponents(std::move(_exponents))
+  {
+  }
+
+  Basis(const Basis& _other)
+    : exponents(_other.exponents)
+  {
+    ++nbCopies;
+  }
+
+  Basis(Basis&&) = default;
+
+  Basis& operator=(const Basis& _other)
+  {
+    exponents = _other.exponents;
+    ++nbCopies;
+    return *this;
+  }
+
+  Basis& operator=(Basis&&) = default;
+};
+
+Basis buildBasis(int _nbAtoms, std::optional<double> _scaling)
+{
+  std::vector<double> exponents;
+  for (int i = 0; i < _nbAtoms; ++i)
+  {
+    exponents.push_back((i + 1) * _scaling.value_or(1.0));
+  }
+  return Basis(std::move(exponents));
+}
+
+#define BUILD_BASIS_VARS (kNbAtoms, kScaling)
+NAMEDPARAMS_PARAMETRIZE(np_buildBasis, &buildBasis, BUILD_BASIS_VARS)
+
+// reads the basis without copying it
+double buildGuess(const Basis& _basis)
+{
+  double guess = 0;
+  for (double exponent : _basis.exponents)
+  {
+    guess += exponent;
+  }
+  return guess;
+}
+
+#define GUESS_VARS (kBasis)
+NAMEDPARAMS_PARAMETRIZE(np_buildGuess, &buildGuess, GUESS_VARS)
+
+std::string runScf(const Basis& _basis, double _guess, std::optional<int> _maxIter)
+{
+  return std::to_string(_basis.exponents.size()) + " " + std::to_string(int(_guess)) + " "
+    + std::to_string(_maxIter.value_or(-1));
+}
+
+#define SCF_VARS (kScfBasis, kGuess, kMaxIter)
+NAMEDPARAMS_PARAMETRIZE(np_runScf, &runScf, SCF_VARS)
+
+// the basis of the SCF is the output of np_buildBasis
+constexpr inline NamedParams::KeyFunction np_runScfOnBasis(NamedParams::FunctionConstant<&runScf>{},
+  kBasis, kGuess, kMaxIter);
+
+// takes the basis by value, as its only consumer it gets the basis moved in
+size_t consumeBasis(Basis _basis, const std::string& _report)
+{
+  return _basis.exponents.size() + _report.size();
+}
+
+#define CONSUME_VARS (kOwnedBasis, kReport)
+NAMEDPARAMS_PARAMETRIZE(np_consumeBasis, &consumeBasis, CONSUME_VARS)
+
+// writes to a non-const reference passed to run
+size_t logAtoms(int _nbAtoms, std::vector<int>& _log)
+{
+  _log.push_back(_nbAtoms);
+  return _log.size();
+}
+
+#define LOG_VARS (kLogAtoms, kLog)
+NAMEDPARAMS_PARAMETRIZE(np_logAtoms, &logAtoms, LOG_VARS)
+
+NAMEDPARAMS_PARAM(kLogSize, size_t);
+
+int fail(int _nbAtoms)
+{
+  if (_nbAtoms > 2)
+  {
+    throw std::runtime_error("failed");
+  }
+  return _nbAtoms;
+}
+
+#define FAIL_VARS (kFailed)
+NAMEDPARAMS_PARAMETRIZE(np_fail, &fail, FAIL_VARS)
+
+constexpr inline NamedParams::KeyFunction np_failOnAtoms(NamedParams::FunctionConstant<&fail>{},
+  kNbAtoms);
+
+int main()
+{
+  int result = 0;
+
+  // kBasis -> kGuess -> kReport, kBasis -> kReport
+  const NamedParams::TaskGraph scfGraph(
+    NamedParams::node(kReport, np_runScfOnBasis),
+    NamedParams::node(kGuess, np_buildGuess),
+    NamedParams::node(kBasis, np_buildBasis));
+
+  auto outputs = scfGraph.run(4, kNbAtoms = 3, kMaxIter = 20);
+  CHECK_EQUAL(*outputs[kReport], "3 6 20", result);
+  CHECK_EQUAL(*outputs[kGuess], 6.0, result);
+  CHECK_EQUAL(outputs[kBasis]->exponents.size(), 3u, result);
+  CHECK_EQUAL(Basis::nbCopies, 0, result);
+
+  // omitted optionals are absent, inputs are passed to every node taking them
+  outputs = scfGraph.run(1, kScaling = 2.0, kNbAtoms = 2);
+  CHECK_EQUAL(*outputs[kReport], "2 6 -1", result);
+
+  // the only by-value consumer gets the output moved in, the output is then empty
+  const NamedParams::TaskGraph consumeGraph(
+    NamedParams::node(kOwnedBasis, np_buildBasis),
+    NamedParams::node(kFailed, np_consumeBasis));
+  auto consumed = consumeGraph.run(kNbAtoms = 4, kReport = std::string("ab"));
+  CHECK_EQUAL(*consumed[kFailed], 6, result);
+  CHECK_EQUAL(consumed[kOwnedBasis].has_value(), false, result);
+  CHECK_EQUAL(Basis::nbCopies, 0, result);
+
+  // non-const references are passed to the nodes
+  std::vector<int> log;
+  const NamedParams::TaskGraph logGraph(NamedParams::node(kLogSize, np_logAtoms));
+  auto logged = logGraph.run(1, kLogAtoms = 3, kLog = log);
+  CHECK_EQUAL(*logged[kLogSize], 1u, result);
+  CHECK_EQUAL(log.size(), 1u, result);
+
+  // exceptions are passed to the caller
+  const NamedParams::TaskGraph failGraph(NamedParams::node(kFailed, np_failOnAtoms));
+  bool hasThrown = false;
+  try
+  {
+    failGraph.run(2, kNbAtoms = 5);
+  }
+  catch (const std::runtime_error&)
+  {
+    hasThrown = true;
+  }
+  CHECK_EQUAL(hasThrown, true, result);
+
+  return result;
+}
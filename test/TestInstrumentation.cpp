@@ -0,0 +1,90 @@
+#define NAMEDPARAMS_ENABLE_INSTRUMENTATION
+#include "../NamedParams.h"
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  } 
+
+int sum(int _a, std::optional<int> _b, std::optional<int> _c) 
+{
+  return _a + (_b ? *_b : 0) + (_c ? *_c : 0);
+}
+
+#define SUM_VARS (keyA, keyB, keyC)
+NAMEDPARAMS_PARAMETRIZE(np_sum, &sum, SUM_VARS)
+
+int main()
+{
+  int result = 0;
+
+  auto work = []()
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      np_sum(keyA = i, keyC = 1);
+    }
+    np_sum(keyB = 2, keyA = 1, keyC = 3);
+  };
+
+  std::thread thread(work);
+  work();
+  thread.join();
+
+  auto stats = NamedParams::Instrumentation::snapshot();
+
+  CHECK_EQUAL(stats.size(), 1, result);
+  CHECK_EQUAL(stats[0].nbCalls, 202, result);
+  CHECK_EQUAL(stats[0].presenceCounts.size(), 2, result);
+  CHECK_EQUAL(stats[0].nbOtherPresenceMasks, 0, result);
+
+  for (const auto& mask : stats[0].presenceCounts)
+  {
+    if (mask.first == 0b101)
+    {
+      CHECK_EQUAL(mask.second, 200, result);
+    }
+    else 
+    {
+      CHECK_EQUAL(mask.first, 0b111, result);
+      CHECK_EQUAL(mask.second, 2, result);
+    }
+  }
+
+  uint64_t nbHistogramCalls = 0;
+  for (auto count : stats[0].latencyHistogram)
+  {
+    nbHistogramCalls += count;
+  }
+  CHECK_EQUAL(nbHistogramCalls, 202, result);
+
+  std::ostringstream dump;
+  NamedParams::Instrumentation::dump(dump);
+  std::cout << dump.str();
+  bool dumpHasCalls = dump.str().find("calls: 202") != std::string::npos;
+  CHECK_EQUAL(dumpHasCalls, true, result);
+
+  NamedParams::Instrumentation::reset();
+  np_sum(keyA = 0);
+
+  stats = NamedParams::Instrumentation::snapshot();
+  CHECK_EQUAL(stats[0].nbCalls, 1, result);
+  CHECK_EQUAL(stats[0].presenceCounts.size(), 1, result);
+
+  // threads which run one after the other reuse the counter block of the finished thread
+  for (int i = 0; i < 10; ++i)
+  {
+    std::thread([]() { np_sum(keyA = 1); }).join();
+  }
+
+  stats = NamedParams::Instrumentation::snapshot();
+  CHECK_EQUAL(stats[0].nbCalls, 11, result);
+  CHECK_EQUAL(stats[0].nbThreadBlocks, 2, result);
+
+  return result;
+}
@@ -0,0 +1,179 @@
+#include "../NamedParamsIpc.h"
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+struct Point
+{
+  double x;
+  double y;
+};
+
+double evaluate(int _order, const Point& _point, std::optional<double> _scaling,
+  NamedParams::OptRef<const int> _offset)
+{
+  return _order * (_point.x + 2 * _point.y) * _scaling.value_or(1.0)
+    + (_offset ? *_offset : 0);
+}
+
+#define EVALUATE_VARS (kOrder, kPoint, kScaling, kOffset)
+NAMEDPARAMS_PARAMETRIZE(np_evaluate, &evaluate, EVALUATE_VARS)
+
+int nbNotified = 0;
+
+void notify(int _count)
+{
+  nbNotified += _count;
+}
+
+#define NOTIFY_VARS (kCount)
+NAMEDPARAMS_PARAMETRIZE(np_notify, &notify, NOTIFY_VARS)
+
+int check(int _value)
+{
+  if (_value < 0)
+  {
+    throw std::invalid_argument("negative value");
+  }
+  return _value;
+}
+
+#define CHECK_VARS (kValue)
+NAMEDPARAMS_PARAMETRIZE(np_check, &check, CHECK_VARS)
+
+int notRegistered(int _i)
+{
+  return _i;
+}
+
+#define NOT_REGISTERED_VARS (kI)
+NAMEDPARAMS_PARAMETRIZE(np_notRegistered, &notRegistered, NOT_REGISTERED_VARS)
+
+// two functions with the same keys, told apart by their names
+int add(int _a, int _b)
+{
+  return _a + _b;
+}
+
+int sub(int _a, int _b)
+{
+  return _a - _b;
+}
+
+#define ADD_VARS (kA, kB)
+NAMEDPARAMS_PARAMETRIZE(np_add, &add, ADD_VARS)
+constexpr inline NamedParams::KeyFunction np_sub(NamedParams::FunctionConstant<&sub>{}, kA, kB);
+
+/// serves calls until stopped, exits with the number of notifications
+int serve(const std::string& _name, size_t _capacity)
+{
+  NamedParams::IpcChannel channel(_name, _capacity, false);
+  NamedParams::IpcDispatcher dispatcher(channel);
+  dispatcher.registerFunction("evaluate", np_evaluate);
+  dispatcher.registerFunction("notify", np_notify);
+  dispatcher.registerFunction("check", np_check);
+  dispatcher.registerFunction("add", np_add);
+  dispatcher.registerFunction("sub", np_sub);
+  dispatcher.serve();
+  return nbNotified;
+}
+
+int main()
+{
+  int result = 0;
+
+  const std::string name = "/NamedParamsTestIpc" + std::to_string(::getpid());
+  // small rings, so messages wrap around
+  const size_t capacity = 256;
+
+  NamedParams::IpcChannel channel(name, capacity, true);
+
+  const pid_t pid = ::fork();
+  if (pid == 0)
+  {
+    ::_exit(serve(name, capacity));
+  }
+
+  NamedParams::IpcClient client(channel);
+  const Point point = {1.0, 2.0};
+  const int offset = 3;
+
+  double sum = 0;
+  for (int i = 0; i < 100; ++i)
+  {
+    sum += client.call("evaluate", np_evaluate, kPoint = point, kOrder = i);
+    sum += client.call("evaluate", np_evaluate, i, point, kOffset = offset);
+    sum += client.call("evaluate", np_evaluate, kScaling = 0.5, kOrder = i, 
+      kPoint = Point{double(i), 1.0});
+    client.call("notify", np_notify, kCount = 1);
+  }
+
+  double expected = 0;
+  for (int i = 0; i < 100; ++i)
+  {
+    expected += np_evaluate(kPoint = point, kOrder = i);
+    expected += np_evaluate(i, point, kOffset = offset);
+    expected += np_evaluate(kScaling = 0.5, kOrder = i, kPoint = Point{double(i), 1.0});
+  }
+  CHECK_EQUAL(sum, expected, result);
+
+  CHECK_EQUAL(client.call("check", np_check, kValue = 7), 7, result);
+
+  // errors in the dispatcher are reported to the client
+  bool hasThrown = false;
+  try
+  {
+    client.call("check", np_check, kValue = -1);
+  }
+  catch (const std::runtime_error&)
+  {
+    hasThrown = true;
+  }
+  CHECK_EQUAL(hasThrown, true, result);
+
+  hasThrown = false;
+  try
+  {
+    client.call("notRegistered", np_notRegistered, kI = 1);
+  }
+  catch (const std::runtime_error&)
+  {
+    hasThrown = true;
+  }
+  CHECK_EQUAL(hasThrown, true, result);
+
+  CHECK_EQUAL(client.call("add", np_add, kB = 2, kA = 5), 7, result);
+  CHECK_EQUAL(client.call("sub", np_sub, kB = 2, kA = 5), 3, result);
+
+  // a function with the same name and keys cannot be registered twice
+  NamedParams::IpcDispatcher dispatcher(channel);
+  dispatcher.registerFunction("add", np_add);
+  dispatcher.registerFunction("sub", np_sub);
+  hasThrown = false;
+  try
+  {
+    dispatcher.registerFunction("add", np_sub);
+  }
+  catch (const std::runtime_error&)
+  {
+    hasThrown = true;
+  }
+  CHECK_EQUAL(hasThrown, true, result);
+
+  client.stop();
+
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  CHECK_EQUAL(WIFEXITED(status), true, result);
+  CHECK_EQUAL(WEXITSTATUS(status), 100, result);
+
+  return result;
+}
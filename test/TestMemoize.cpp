@@ -0,0 +1,169 @@
+#include "../NamedParamsMemoize.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  } 
+
+std::atomic<int> nbEvaluations = 0;
+
+std::string repeat(const std::string& _str, int _n, std::optional<std::string> _delim)
+{
+  ++nbEvaluations;
+  std::string out;
+  for (int i = 0; i < _n; ++i)
+  {
+    out += (i > 0 && _delim) ? *_delim + _str : _str;
+  }
+  return out;
+}
+
+#define REPEAT_VARS (keyStr, keyN, keyDelim)
+NAMEDPARAMS_MEMOIZE(np_repeat, 2, 1, &repeat, REPEAT_VARS)
+
+int square(int _i)
+{
+  ++nbEvaluations;
+  return _i * _i;
+}
+
+#define SQUARE_VARS (keyI)
+NAMEDPARAMS_MEMOIZE(np_square, 256, 8, &square, SQUARE_VARS)
+
+// argument which counts its copies
+struct Basis
+{
+  std::vector<double> exponents;
+
+  Basis(std::vector<double> _exponents)
+    : exponents(std::move(_exponents))
+  {
+  }
+
+  Basis(const Basis& _other)
+    : exponents(_other.exponents)
+  {
+    ++nbCopies;
+  }
+
+  Basis(Basis&& _other) = default;
+
+  bool operator==(const Basis& _other) const
+  {
+    return exponents == _other.exponents;
+  }
+
+  static inline int nbCopies = 0;
+};
+
+template <>
+struct std::hash<Basis>
+{
+  size_t operator()(const Basis& _basis) const
+  {
+    return _basis.exponents.size();
+  }
+};
+
+double sumExponents(const Basis& _basis, std::optional<double> _scaling)
+{
+  ++nbEvaluations;
+  double sum = 0;
+  for (double exponent : _basis.exponents)
+  {
+    sum += exponent;
+  }
+  return sum * _scaling.value_or(1.0);
+}
+
+#define SUM_EXPONENTS_VARS (keyBasis, keyScaling)
+NAMEDPARAMS_MEMOIZE(np_sumExponents, 16, 2, &sumExponents, SUM_EXPONENTS_VARS)
+
+int main()
+{
+  int result = 0;
+
+  std::string str = "ab";
+
+  // order of the keys does not matter
+  CHECK_EQUAL(np_repeat(keyStr = str, keyN = 3), "ababab", result);
+  CHECK_EQUAL(np_repeat(keyN = 3, keyStr = str), "ababab", result);
+  CHECK_EQUAL(np_repeat(str, 3), "ababab", result);
+  CHECK_EQUAL(nbEvaluations, 1, result);
+
+  // absent optional is different from a present one
+  CHECK_EQUAL(np_repeat(str, 3, keyDelim = "-"), "ab-ab-ab", result);
+  CHECK_EQUAL(nbEvaluations, 2, result);
+
+  // capacity of 2, first entry is evicted
+  CHECK_EQUAL(np_repeat(str, 1), "ab", result);
+  CHECK_EQUAL(np_repeat(keyStr = str, keyN = 3), "ababab", result);
+  CHECK_EQUAL(nbEvaluations, 4, result);
+
+  auto stats = np_repeat.getStatistics();
+  CHECK_EQUAL(stats.nbHits, 2, result);
+  CHECK_EQUAL(stats.nbMisses, 4, result);
+  CHECK_EQUAL(stats.nbEvictions, 2, result);
+  CHECK_EQUAL(stats.size, 2, result);
+
+  // invalidation
+  CHECK_EQUAL(np_repeat.invalidate(keyN = 3, keyStr = str), true, result);
+  CHECK_EQUAL(np_repeat.invalidate(keyN = 3, keyStr = str), false, result);
+  CHECK_EQUAL(np_repeat(str, 3), "ababab", result);
+  CHECK_EQUAL(nbEvaluations, 5, result);
+
+  np_repeat.invalidate();
+  CHECK_EQUAL(np_repeat.getStatistics().size, 0, result);
+
+  // arguments are only copied into the cache on a miss, hits compare with the passed arguments
+  nbEvaluations = 0;
+  const Basis basis({1.0, 2.0, 3.0});
+  CHECK_EQUAL(np_sumExponents(keyBasis = basis), 6.0, result);
+  CHECK_EQUAL(Basis::nbCopies, 1, result);
+  CHECK_EQUAL(np_sumExponents(keyBasis = basis), 6.0, result);
+  CHECK_EQUAL(np_sumExponents(keyScaling = std::nullopt, keyBasis = basis), 6.0, result);
+  CHECK_EQUAL(Basis::nbCopies, 1, result);
+  CHECK_EQUAL(nbEvaluations, 1, result);
+  CHECK_EQUAL(np_sumExponents(basis, 0.5), 3.0, result);
+  CHECK_EQUAL(Basis::nbCopies, 2, result);
+  CHECK_EQUAL(np_sumExponents.invalidate(keyBasis = basis, keyScaling = 0.5), true, result);
+  CHECK_EQUAL(Basis::nbCopies, 2, result);
+
+  // concurrent access
+  nbEvaluations = 0;
+  std::vector<std::thread> threads;
+  std::atomic<int> nbWrong = 0;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&]()
+    {
+      for (int rep = 0; rep < 100; ++rep)
+      {
+        for (int i = 0; i < 32; ++i)
+        {
+          if (np_square(keyI = i) != i*i)
+          {
+            ++nbWrong;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  CHECK_EQUAL(nbWrong, 0, result);
+  CHECK_EQUAL(np_square.getStatistics().size, 32, result);
+  CHECK_EQUAL(np_square.getStatistics().nbHits + np_square.getStatistics().nbMisses, 12800, result);
+
+  return result;
+}
@@ -2,6 +2,7 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #define CHECK_EQUAL(_A, _B, _RETURN) \
   if (_A != _B) \
@@ -53,6 +54,34 @@ int sumPointer(int* p0, int const* p1, const int* p2)
 #define SUM_POINTER_VARS (keyP0, keyP1, keyP2)
 NAMEDPARAMS_PARAMETRIZE(np_sumPointer, &sumPointer, SUM_POINTER_VARS)
 
+// function with hinted pointers, for testing NamedParams::aligned and NamedParams::noalias
+double dotHinted(NamedParams::AlignedPtr<const double,32> _x, NamedParams::NoAliasPtr<double> _y, 
+  size_t _size)
+{
+  double* NAMEDPARAMS_RESTRICT y = _y.get();
+  double dot = 0;
+  for (size_t i = 0; i < _size; ++i)
+  {
+    dot += _x[i] * y[i];
+    y[i] = 0;
+  }
+  return dot;
+}
+
+#define DOT_HINTED_VARS (keyHintedX, keyHintedY, keyHintedSize)
+NAMEDPARAMS_PARAMETRIZE(np_dotHinted, &dotHinted, DOT_HINTED_VARS)
+
+// hints can be weakened, but not added
+static_assert(std::is_convertible<NamedParams::AlignedPtr<const double,64>, 
+  NamedParams::AlignedPtr<const double,32>>::value);
+static_assert(!std::is_convertible<NamedParams::AlignedPtr<const double,16>, 
+  NamedParams::AlignedPtr<const double,32>>::value);
+static_assert(!std::is_convertible<const double*, NamedParams::AlignedPtr<const double,32>>::value);
+static_assert(std::is_convertible<NamedParams::NoAliasPtr<double,64>, 
+  NamedParams::NoAliasPtr<double>>::value);
+static_assert(!std::is_convertible<NamedParams::AlignedPtr<double,64>, 
+  NamedParams::NoAliasPtr<double>>::value);
+
 int singleArgument(std::optional<int> _i)
 {
   return _i ? *_i : 0;
@@ -77,6 +106,31 @@ int processUncopyable([[maybe_unused]]Uncopyable& _ucopy)
 #define UNCOPYABLE_VARS (pcopy)
 NAMEDPARAMS_PARAMETRIZE(np_processUncopyable, &processUncopyable, UNCOPYABLE_VARS)
 
+const Uncopyable* processOptionalUncopyable(int _i, NamedParams::OptRef<const Uncopyable> _ucopy)
+{
+  return (_i > 0 && _ucopy) ? _ucopy.get() : nullptr;
+}
+
+#define OPT_UNCOPYABLE_VARS (optI, optUcopy)
+NAMEDPARAMS_PARAMETRIZE(np_processOptionalUncopyable, &processOptionalUncopyable, 
+  OPT_UNCOPYABLE_VARS)
+
+// OptRef does not bind temporaries
+static_assert(std::is_constructible<NamedParams::OptRef<const int>, const int&>::value);
+static_assert(std::is_constructible<NamedParams::OptRef<const int>, int&>::value);
+static_assert(!std::is_constructible<NamedParams::OptRef<const int>, int>::value);
+static_assert(!std::is_constructible<NamedParams::OptRef<const int>, const int&&>::value);
+static_assert(!std::is_constructible<NamedParams::OptRef<int>, int>::value);
+
+// function for testing that positionals are copied and converted like in a direct call
+std::string scaleLabel(std::string _label, float _scale, std::optional<std::string> _unit)
+{
+  return _label + std::to_string(_scale) + _unit.value_or("");
+}
+
+#define SCALE_LABEL_VARS (label, scale, unit)
+NAMEDPARAMS_PARAMETRIZE(np_scaleLabel, &scaleLabel, SCALE_LABEL_VARS)
+
 
 class Test
 {
@@ -160,6 +214,228 @@ int manyArgs(int i0, int i1, int i2, int i3, int i4, int i5, int i6, int i7, int
 
 NAMEDPARAMS_PARAMETRIZE(np_manyArgs, &manyArgs, MANY_ARGS_VARS)
 
+// function for testing named multi-value returns
+NAMEDPARAMS_RESULT(DivisionResult, ((kQuotient, int), (kRemainder, int), (kWarning, std::optional<std::string>)))
+
+DivisionResult divide(int _dividend, int _divisor, std::optional<bool> _floor)
+{
+  if (_divisor == 0)
+  {
+    return DivisionResult(0, 0, kWarning = "division by zero");
+  }
+  
+  int quotient = _dividend / _divisor;
+  int remainder = _dividend % _divisor;
+  if (_floor.value_or(false) && remainder != 0 && ((remainder < 0) != (_divisor < 0)))
+  {
+    --quotient;
+    remainder += _divisor;
+  }
+
+  return {kRemainder = remainder, kQuotient = quotient};
+}
+
+#define DIVIDE_VARS (dividend, divisor, floorDivision)
+NAMEDPARAMS_PARAMETRIZE(np_divide, &divide, DIVIDE_VARS)
+
+// invalid arguments fail in overload resolution, a single argument does not convert implicitly
+static_assert(std::is_constructible<DivisionResult, int, int>::value);
+static_assert(!std::is_constructible<DivisionResult, std::string, int>::value);
+static_assert(!std::is_constructible<DivisionResult, int, int, decltype(dividend = 1)>::value);
+static_assert(!std::is_convertible<int, DivisionResult>::value);
+
+// aggregate struct for testing np_init
+struct Parameters
+{
+  Uncopyable& ucopy;
+  int method;
+  float scaling;
+  std::optional<int> nbBatches;
+  std::optional<std::string> guess;
+
+  NAMEDPARAMS_AGGREGATE(Parameters, ((kUcopy, ucopy), (kMethod, method), (kScaling, scaling), 
+                                     (kNbBatches, nbBatches), (kGuess, guess)))
+};
+
+// template callee for testing KeyTemplateFunction, omitted optionals are absent_t
+struct Polynomial
+{
+  template <class TLinear, class TQuadratic>
+  double operator()(double _x, double _constant, TLinear _linear, TQuadratic _quadratic) const
+  {
+    double value = _constant;
+    if constexpr (!NamedParams::IsAbsent<TLinear>::value)
+    {
+      value += _linear.value_or(0.0) * _x;
+    }
+    if constexpr (!NamedParams::IsAbsent<TQuadratic>::value)
+    {
+      value += _quadratic.value_or(0.0) * _x * _x;
+    }
+    return value;
+  }
+};
+
+using PolynomialSignature = double(double, double, std::optional<double>, std::optional<double>);
+
+#define POLYNOMIAL_VARS (polyX, polyConstant, polyLinear, polyQuadratic)
+NAMEDPARAMS_PARAMETRIZE_TEMPLATE(np_polynomial, Polynomial{}, PolynomialSignature, POLYNOMIAL_VARS)
+
+// returns a mask of the arguments which are absent_t
+struct AbsenceMask
+{
+  template <class... T>
+  int operator()(T&&...) const
+  {
+    int mask = 0;
+    int bit = 1;
+    ((mask |= (NamedParams::IsAbsent<T>::value ? bit : 0), bit <<= 1), ...);
+    return mask;
+  }
+};
+
+#define ABSENCE_VARS (maskX, maskConstant, maskLinear, maskQuadratic)
+NAMEDPARAMS_PARAMETRIZE_TEMPLATE(np_absenceMask, AbsenceMask{}, PolynomialSignature, ABSENCE_VARS)
+
+enum class Variant
+{
+  SCALAR,
+  UNROLLED
+};
+
+// template callee with a code path selected by a key, constants select it at compile time
+struct Blend
+{
+  template <class TVariant, class TFactor>
+  double operator()(const std::vector<double>& _values, TVariant _variant, TFactor _factor) const
+  {
+    double sum = 0;
+    if constexpr (NamedParams::IsConstant<TVariant>::value)
+    {
+      static_assert(TVariant::value == Variant::UNROLLED);
+      for (size_t i = 0; i < _values.size(); i += 2)
+      {
+        sum += _values[i] + (i + 1 < _values.size() ? _values[i + 1] : 0.0);
+      }
+      sum += 1000;
+    }
+    else
+    {
+      for (double value : _values)
+      {
+        sum += value;
+      }
+      sum += (_variant == Variant::UNROLLED) ? 100 : 0;
+    }
+    if constexpr (NamedParams::IsConstant<TFactor>::value)
+    {
+      return sum * TFactor::value;
+    }
+    else if constexpr (NamedParams::IsAbsent<TFactor>::value)
+    {
+      return sum;
+    }
+    else
+    {
+      return sum * _factor.value_or(1);
+    }
+  }
+};
+
+using BlendSignature = double(const std::vector<double>&, Variant, std::optional<int>);
+
+#define BLEND_VARS (kBlendValues, kBlendVariant, kBlendFactor)
+NAMEDPARAMS_PARAMETRIZE_TEMPLATE(np_blend, Blend{}, BlendSignature, BLEND_VARS)
+
+// interchangeable implementations with one key set, for testing NamedFunctionRef
+double solveDiis(const std::vector<double>& _input, int _maxIter, std::optional<double> _damping)
+{
+  return _input.size() * _maxIter * _damping.value_or(1.0);
+}
+
+double solveLevelShift(const std::vector<double>& _input, int _maxIter, 
+  std::optional<double> _damping)
+{
+  return -solveDiis(_input, _maxIter, _damping);
+}
+
+#define SOLVER_VARS (kSolverInput, kSolverIter, kSolverDamping)
+NAMEDPARAMS_PARAMETRIZE(np_solveDiis, &solveDiis, SOLVER_VARS)
+constexpr inline NamedParams::KeyFunction np_solveLevelShift(
+  NamedParams::FunctionConstant<&solveLevelShift>{}, kSolverInput, kSolverIter, kSolverDamping);
+
+typedef NamedParams::NamedFunctionRef<double, decltype(kSolverInput), decltype(kSolverIter), 
+  decltype(kSolverDamping)> SolverRef;
+
+// discards the results of the implementations
+typedef NamedParams::NamedFunctionRef<void, decltype(kSolverInput), decltype(kSolverIter), 
+  decltype(kSolverDamping)> SolverSink;
+
+// function with several optionals, for testing OptionSet
+std::string runScf(int _maxIter, std::optional<bool> _doDiis, std::optional<double> _threshold, 
+  std::optional<std::string> _guess, std::optional<char> _grid)
+{
+  return std::to_string(_maxIter) + (_doDiis.value_or(false) ? " diis" : "") 
+    + (_threshold ? " " + std::to_string(int(*_threshold * 1000)) : "") + " " 
+    + _guess.value_or("core") + " " + _grid.value_or('-');
+}
+
+#define SCF_VARS (kScfIter, kScfDiis, kScfThreshold, kScfGuess, kScfGrid)
+NAMEDPARAMS_PARAMETRIZE(np_runScf, &runScf, SCF_VARS)
+
+typedef NamedParams::OptionSet<decltype(kScfDiis), decltype(kScfThreshold), decltype(kScfGuess),
+  decltype(kScfGrid)> ScfOptions;
+
+// the values are packed without padding, followed by the bitmask
+static_assert(sizeof(ScfOptions) < sizeof(std::optional<bool>) + sizeof(std::optional<double>) 
+  + sizeof(std::optional<std::string>) + sizeof(std::optional<char>));
+
+// function which reads its arguments by key from a NamedArgs
+using ShiftSignature = std::string(const std::string&, int&, double, std::optional<double>, 
+  std::optional<std::string>);
+
+#define SHIFT_VARS (kShiftLabel, kShiftCounter, kShiftValue, kShiftScaling, kShiftUnit)
+NAMEDPARAMS_ARGS(ShiftArgs, ShiftSignature, SHIFT_VARS)
+
+const std::string* shiftedLabel = nullptr;
+
+std::string shift(const ShiftArgs& _args)
+{
+  ++_args[kShiftCounter];
+  shiftedLabel = &_args[kShiftLabel];
+
+  std::string out = _args[kShiftLabel] + " " 
+    + std::to_string(int(_args[kShiftValue] * _args.getOr(kShiftScaling, 1.0)));
+  if (_args.has(kShiftUnit))
+  {
+    out += " " + *_args[kShiftUnit];
+  }
+  return out;
+}
+
+NAMEDPARAMS_PARAMETRIZE_ARGS(np_shift, &shift)
+
+static_assert(std::is_same<decltype(std::declval<const ShiftArgs&>()[kShiftCounter]), int&>::value);
+static_assert(std::is_same<decltype(std::declval<const ShiftArgs&>()[kShiftValue]), 
+  const double&>::value);
+static_assert(std::is_same<decltype(std::declval<const ShiftArgs&>()[kShiftScaling]), 
+  const std::optional<double>&>::value);
+
+// configuration object for testing np_update
+class Settings
+{
+  public:
+
+    int scfMaxIter = 20;
+    double scaling = 1.0;
+    std::vector<double> grid;
+    std::optional<std::string> guess;
+
+    NAMEDPARAMS_MEMBER_KEYS(Settings, ((kScfMaxIter, scfMaxIter), (kScaling, scaling)))
+};
+
+NAMEDPARAMS_MEMBER_KEYS(Settings, ((kGrid, grid), (kGuess, guess)))
+
 int main()
 {
 
@@ -180,6 +456,23 @@ int main()
 
   CHECK_EQUAL(0, ret, result);
 
+  const Uncopyable* pUcopy = np_processOptionalUncopyable(optUcopy = ucopy, optI = 1);
+  CHECK_EQUAL(pUcopy, &ucopy, result);
+
+  pUcopy = np_processOptionalUncopyable(optI = 1);
+  CHECK_EQUAL(pUcopy, nullptr, result);
+
+  std::string labelName = "abc";
+  double scaling = 1.5;
+  std::string scaledLabel = np_scaleLabel(labelName, scaling, unit = "m");
+
+  CHECK_EQUAL(labelName, "abc", result);
+  CHECK_EQUAL(scaledLabel, "abc" + std::to_string(1.5f) + "m", result);
+
+  // permutations of the same keys share one call thunk
+  CHECK_EQUAL(np_scaleLabel(unit = "s", scale = 2, label = labelName), 
+    np_scaleLabel(label = labelName, scale = 2, unit = "s"), result);
+
   int sum = np_sum(keyA = 1, keyB = 2, keyD = 4);
 
   CHECK_EQUAL(sum, 9, result);
@@ -191,6 +484,12 @@ int main()
   int sumP = np_sumPointer(keyP0 = &i0, keyP1 = &i1, keyP2 = &i2);
 
   CHECK_EQUAL(sumP, 3, result);
+
+  alignas(64) const double hintedX[4] = {1.0, 2.0, 3.0, 4.0};
+  double hintedY[4] = {1.0, 1.0, 1.0, 2.0};
+  CHECK_ALMOST_EQUAL(np_dotHinted(keyHintedX = NamedParams::aligned<64>(hintedX), 
+    keyHintedY = NamedParams::noalias(hintedY), keyHintedSize = size_t(4)), 14.0, result);
+  CHECK_ALMOST_EQUAL(hintedY[3], 0.0, result);
   
   Test t0 = Test::buildWrapper(Test::paramF = 3.14, Test::paramS = "HELLO", Test::paramI = 1);
   CHECK_EQUAL(t0.m_int, 1, result);
@@ -203,6 +502,129 @@ int main()
   CHECK_EQUAL(ret6, 0, result);
   CHECK_ALMOST_EQUAL(val, 11.0, result);
 
+  Parameters params = NamedParams::np_init<Parameters>(Parameters::kGuess = "sad", 
+    Parameters::kMethod = 2, Parameters::kUcopy = ucopy, Parameters::kScaling = 0.5);
+
+  CHECK_EQUAL(&params.ucopy, &ucopy, result);
+  CHECK_EQUAL(params.method, 2, result);
+  CHECK_ALMOST_EQUAL(params.scaling, 0.5, result);
+  CHECK_EQUAL(params.nbBatches.has_value(), false, result);
+  CHECK_EQUAL(*params.guess, "sad", result);
+
+  Parameters params2 = NamedParams::np_init<Parameters>(ucopy, 3, 1.5, Parameters::kNbBatches = 4);
+
+  CHECK_EQUAL(params2.method, 3, result);
+  CHECK_ALMOST_EQUAL(params2.scaling, 1.5, result);
+  CHECK_EQUAL(*params2.nbBatches, 4, result);
+  CHECK_EQUAL(params2.guess.has_value(), false, result);
+
+  CHECK_ALMOST_EQUAL(np_polynomial(2.0, 1.0, polyQuadratic = 3.0), 13.0, result);
+  CHECK_ALMOST_EQUAL(np_polynomial(polyLinear = 0.5, polyConstant = 1.0, polyX = 2.0), 2.0, result);
+
+  CHECK_EQUAL(np_absenceMask(1.0, 2.0), 0xc, result);
+  // std::nullopt is passed, not absent
+  CHECK_EQUAL(np_absenceMask(1.0, 2.0, maskLinear = std::nullopt), 0x8, result);
+  CHECK_EQUAL(np_absenceMask(1.0, 2.0, 3.0, maskQuadratic = 4.0), 0x0, result);
+
+  // compile-time constants are passed as std::integral_constant, runtime values as usual
+  const std::vector<double> blendValues = {1.0, 2.0, 3.0};
+  CHECK_ALMOST_EQUAL(np_blend(blendValues, kBlendVariant = NamedParams::constant<Variant::UNROLLED>),
+    1006.0, result);
+  CHECK_ALMOST_EQUAL(np_blend(blendValues, NamedParams::constant<Variant::UNROLLED>, 
+    kBlendFactor = NamedParams::constant<2>), 2012.0, result);
+  CHECK_ALMOST_EQUAL(np_blend(kBlendVariant = Variant::UNROLLED, kBlendValues = blendValues, 
+    kBlendFactor = 2), 212.0, result);
+  // a KeyFunction gets the value of a constant
+  CHECK_EQUAL(np_sum(NamedParams::constant<2>, keyB = NamedParams::constant<3>, 
+    keyC = NamedParams::constant<4>), 12, result);
+
+  Settings settings;
+  std::vector<double> grid(1000, 0.5);
+  const double* gridData = grid.data();
+
+  NamedParams::np_update(settings, kGuess = "sad", Settings::kScaling = 2.0, 
+    kGrid = std::move(grid), Settings::kScfMaxIter = 50);
+
+  CHECK_EQUAL(settings.scfMaxIter, 50, result);
+  CHECK_ALMOST_EQUAL(settings.scaling, 2.0, result);
+  CHECK_EQUAL(*settings.guess, "sad", result);
+  // the grid is moved into the object
+  CHECK_EQUAL(settings.grid.data(), gridData, result);
+
+  NamedParams::np_update(settings, kGuess = std::nullopt).scfMaxIter += 1;
+
+  CHECK_EQUAL(settings.guess.has_value(), false, result);
+  CHECK_EQUAL(settings.scfMaxIter, 51, result);
+  CHECK_ALMOST_EQUAL(settings.scaling, 2.0, result);
+
+  auto [quotient, remainder, warning] = np_divide(divisor = 4, dividend = -7, floorDivision = true);
+
+  CHECK_EQUAL(quotient, -2, result);
+  CHECK_EQUAL(remainder, 1, result);
+  CHECK_EQUAL(warning.has_value(), false, result);
+
+  DivisionResult division = np_divide(7, 0);
+
+  CHECK_EQUAL(division[kQuotient], 0, result);
+  CHECK_EQUAL(*division[kWarning], "division by zero", result);
+
+  division[kRemainder] = 3;
+  CHECK_EQUAL(division.get<1>(), 3, result);
+
+  // implementations chosen at runtime through NamedFunctionRef
+  const std::vector<double> solverInput = {1.0, 2.0};
+  const auto halfSolver = [](const std::vector<double>& _input, int _maxIter, 
+    std::optional<double>) { return 0.5 * _input.size() * _maxIter; };
+  const SolverRef solvers[] = {np_solveDiis, np_solveLevelShift, &solveDiis, halfSolver};
+
+  CHECK_ALMOST_EQUAL(solvers[0](kSolverIter = 3, kSolverInput = solverInput), 6.0, result);
+  CHECK_ALMOST_EQUAL(solvers[1](solverInput, kSolverDamping = 0.5, kSolverIter = 3), -3.0, result);
+  CHECK_ALMOST_EQUAL(solvers[2](solverInput, 4), 8.0, result);
+  CHECK_ALMOST_EQUAL(solvers[3](kSolverInput = solverInput, kSolverIter = 4), 4.0, result);
+
+  int nbSunk = 0;
+  const auto countingSolver = [&nbSunk](const std::vector<double>&, int _maxIter, 
+    std::optional<double>) { return nbSunk += _maxIter; };
+  const SolverSink sinks[] = {np_solveDiis, countingSolver};
+  sinks[0](kSolverIter = 3, kSolverInput = solverInput);
+  sinks[1](solverInput, 2);
+  sinks[1](kSolverIter = 5, kSolverInput = solverInput);
+  CHECK_EQUAL(nbSunk, 7, result);
+
+  // stored optionals, expanded when passed to a function
+  ScfOptions scfOptions(kScfThreshold = 0.25, kScfGuess = std::string("sad"));
+  CHECK_EQUAL(scfOptions.has(kScfThreshold), true, result);
+  CHECK_EQUAL(scfOptions.has(kScfDiis), false, result);
+  CHECK_EQUAL(scfOptions.value(kScfGuess), "sad", result);
+  CHECK_EQUAL(scfOptions.valueOr(kScfGrid, 'x'), 'x', result);
+  CHECK_EQUAL(int(scfOptions.getMask()), 6, result);
+  CHECK_EQUAL(np_runScf(kScfIter = 10, scfOptions), "10 250 sad -", result);
+
+  // explicit keys and positionals take precedence over the set
+  CHECK_EQUAL(np_runScf(3, kScfGuess = "huckel", scfOptions), "3 250 huckel -", result);
+  CHECK_EQUAL(np_runScf(scfOptions, 3, std::optional<bool>(true)), "3 diis 250 sad -", result);
+
+  ScfOptions scfCopy = scfOptions;
+  scfCopy.set(kScfGrid, 'f');
+  scfCopy.reset(kScfThreshold);
+  CHECK_EQUAL(scfCopy.get(kScfThreshold).has_value(), false, result);
+  CHECK_EQUAL(np_runScf(1, scfCopy), "1 sad f", result);
+  CHECK_EQUAL(np_runScf(1, scfOptions), "1 250 sad -", result);
+
+  scfCopy = ScfOptions();
+  CHECK_EQUAL(np_runScf(1, scfCopy), "1 core -", result);
+
+  // functions taking NamedArgs read the values of the caller by key
+  const std::string shiftLabel = "x";
+  int shiftCounter = 0;
+  CHECK_EQUAL(np_shift(kShiftValue = 2.5, kShiftCounter = shiftCounter, kShiftLabel = shiftLabel), 
+    "x 2", result);
+  CHECK_EQUAL(shiftedLabel, &shiftLabel, result);
+  CHECK_EQUAL(np_shift(shiftLabel, shiftCounter, 3, kShiftUnit = std::string("m"), 
+    kShiftScaling = 2.0), "x 6 m", result);
+  CHECK_EQUAL(np_shift("y", shiftCounter, 1.5, std::nullopt), "y 1", result);
+  CHECK_EQUAL(shiftCounter, 3, result);
+
   //testKey.test<0>();
   auto start = std::chrono::steady_clock::now();
   int sumArgs = np_manyArgs(keyI5 = 5, keyI0 = 0, keyI1 = 1, keyI2 = 2, keyI6 = 6, keyI7 = 7, 
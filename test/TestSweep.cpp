@@ -0,0 +1,122 @@
+#include "../NamedParamsSweep.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define CHECK_EQUAL(_A, _B, _RETURN) \
+  if (_A != _B) \
+  { \
+    std::cerr << "Not equal: " << #_A << " " << #_B << std::endl; \
+    _RETURN += 1; \
+  }
+
+struct Basis
+{
+  std::vector<double> exponents;
+};
+
+std::atomic<int> nbCalls(0);
+
+double compute(const Basis& _basis, int _nbBatches, std::optional<double> _scaling,
+  std::vector<int> _weights)
+{
+  ++nbCalls;
+  // points have very different costs
+  std::this_thread::sleep_for(std::chrono::microseconds(100 * _nbBatches));
+
+  double sum = 0;
+  for (double exponent : _basis.exponents)
+  {
+    sum += exponent;
+  }
+  return sum * _nbBatches * _scaling.value_or(1.0) + _weights.size();
+}
+
+#define COMPUTE_VARS (kBasis, kNbBatches, kScaling, kWeights)
+NAMEDPARAMS_PARAMETRIZE(np_compute, &compute, COMPUTE_VARS)
+
+int visited[3][2] = {};
+
+void visit(int _i, int _j)
+{
+  ++visited[_i][_j];
+}
+
+#define VISIT_VARS (kVisitI, kVisitJ)
+NAMEDPARAMS_PARAMETRIZE(np_visit, &visit, VISIT_VARS)
+
+int fail(int _i)
+{
+  if (_i == 3)
+  {
+    throw std::runtime_error("failed");
+  }
+  return _i;
+}
+
+#define FAIL_VARS (kFailI)
+NAMEDPARAMS_PARAMETRIZE(np_fail, &fail, FAIL_VARS)
+
+int main()
+{
+  int result = 0;
+
+  const Basis basis = {{1.0, 2.0}};
+  const std::vector<int> weights = {1, 2, 3};
+
+  auto grid = NamedParams::sweep(4, np_compute, kScaling = {0.5, 1.0, 2.0},
+    kNbBatches = {1, 2, 4, 8}, kBasis = basis, kWeights = weights);
+
+  CHECK_EQUAL(nbCalls, 12, result);
+  CHECK_EQUAL(grid.size(), 12u, result);
+  CHECK_EQUAL(grid.getShape()[0], 3u, result);
+  CHECK_EQUAL(grid.getShape()[1], 4u, result);
+
+  const double scalings[] = {0.5, 1.0, 2.0};
+  const int nbBatches[] = {1, 2, 4, 8};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t j = 0; j < 4; ++j)
+    {
+      const double expected = np_compute(kBasis = basis, kNbBatches = nbBatches[j],
+        kScaling = scalings[i], kWeights = weights);
+      CHECK_EQUAL(grid(i, j), expected, result);
+      CHECK_EQUAL(grid[i * 4 + j], expected, result);
+    }
+  }
+
+  const std::array<size_t,2> indices = grid.getIndices(7);
+  CHECK_EQUAL(indices[0], 1u, result);
+  CHECK_EQUAL(indices[1], 3u, result);
+
+  // fixed keys only: a single point
+  auto single = NamedParams::sweep(np_compute, kNbBatches = 1, kBasis = basis, kWeights = weights);
+  CHECK_EQUAL(single.size(), 1u, result);
+  CHECK_EQUAL(single[0], 3.0 + 3, result);
+
+  // functions returning void, each point is called exactly once
+  const size_t nbPoints = NamedParams::sweep(3, np_visit, kVisitJ = {0, 1}, kVisitI = {0, 1, 2});
+  CHECK_EQUAL(nbPoints, 6u, result);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t j = 0; j < 2; ++j)
+    {
+      CHECK_EQUAL(visited[i][j], 1, result);
+    }
+  }
+
+  // exceptions are passed to the caller
+  bool hasThrown = false;
+  try
+  {
+    NamedParams::sweep(2, np_fail, kFailI = {1, 2, 3, 4, 5});
+  }
+  catch (const std::runtime_error&)
+  {
+    hasThrown = true;
+  }
+  CHECK_EQUAL(hasThrown, true, result);
+
+  return result;
+}
@@ -1,4 +1,5 @@
-#include "../NamedParams.h"
+#include "../NamedParamsSweep.h"
+#include <string>
 
 int func_base(int a, float& b, double c, std::optional<int> d, std::optional<std::string> e)
 {
@@ -8,31 +9,104 @@ int func_base(int a, float& b, double c, std::optional<int> d, std::optional<std
 #define VARS (keyA, keyB, keyC, keyD, keyE)
 NAMEDPARAMS_PARAMETRIZE(func, &func_base, VARS)
 
+struct TemplateCallee
+{
+	template <class TD>
+	int operator()(int a, TD d) const
+	{
+		return a;
+	}
+};
+
+using TemplateSignature = int(int, std::optional<int>);
+
+NAMEDPARAMS_PARAMETRIZE_TEMPLATE(templateFunc, TemplateCallee{}, TemplateSignature, 
+	(keyTemplateA, keyTemplateD))
+
 NAMEDPARAMS_PARAM(keyINVALID, int);
+
+typedef NamedParams::OptionSet<decltype(keyD), decltype(keyE)> Options;
+
+// only the promise_type matters for the check
+struct CoroutineTask
+{
+	struct promise_type {};
+};
+
+CoroutineTask coroutine_base(const std::string& label);
+
+NAMEDPARAMS_PARAMETRIZE(coroutine, &coroutine_base, (keyLabel))
+
+CoroutineTask declaredCoroutine_base(const std::string& label);
+
+NAMEDPARAMS_PARAMETRIZE(declaredCoroutine, &declaredCoroutine_base, (keyDeclaredLabel))
+NAMEDPARAMS_DECLARE_CALL(declaredCoroutine, (keyDeclaredLabel))
+
+struct Settings
+{
+	int maxIter;
+	double scaling;
+};
+
+NAMEDPARAMS_MEMBER_KEYS(Settings, ((keyMaxIter, maxIter), (keyScaling, scaling)))
+
+struct Aggregate
+{
+	int a;
+	std::optional<int> b;
+
+	NAMEDPARAMS_AGGREGATE(Aggregate, ((keyMemberA, a), (keyMemberB, b)))
+};
   
+// Each case is compiled on its own with THIS_WILL_NOT_COMPILE_CASE set to its number, and 
+// its compiler output has to contain the diagnostic after the number
 int main() 
 {
-	int ret;
+	int ret = 0;
 	float b = 2;
+	Options options(keyD = 1);
+	Settings settings;
 
-	// missing key
+#if THIS_WILL_NOT_COMPILE_CASE == 1 // MISSING_KEY
 	ret = func(0, b, keyD=5);
+#elif THIS_WILL_NOT_COMPILE_CASE == 2 // MISSING_KEY
 	ret = func(keyC = 3.0, keyA = 1);
-
-	// invalid key
+#elif THIS_WILL_NOT_COMPILE_CASE == 3 // INVALID_KEY
 	ret = func(0, b, keyINVALID = 5);
-
-	// multiple keys
+#elif THIS_WILL_NOT_COMPILE_CASE == 4 // SAME_KEY_PASSED_MORE_THAN_ONCE
 	ret = func(keyA = 0, keyB = b, keyA = 1);
-
-	// positional after key
+#elif THIS_WILL_NOT_COMPILE_CASE == 5 // POSITIONAL_CANNOT_FOLLOW_KEY_ARGUMENT
 	ret = func(keyA = 0, b);
-
-	// argument cannot be converted
+#elif THIS_WILL_NOT_COMPILE_CASE == 6 // COULD_NOT_CONVERT_KEY_TYPE_TO_ARGUMENT_TYPE
 	ret = func(1, 2, 3.0, 4.0);
-
-	// too many
+#elif THIS_WILL_NOT_COMPILE_CASE == 7 // TOO_MANY_ARGUMENTS_PASSED_TO_FUNCTION
 	ret = func(1, b, 3.0, 4.0, 5.0, 6.0, 7.0);
+#elif THIS_WILL_NOT_COMPILE_CASE == 8 // TEMPORARY_BOUND_TO_COROUTINE_REFERENCE
+	// temporary bound to a reference of a coroutine
+	coroutine(keyLabel = std::string("label"));
+#elif THIS_WILL_NOT_COMPILE_CASE == 9 // TEMPORARY_BOUND_TO_COROUTINE_REFERENCE
+	coroutine("label");
+#elif THIS_WILL_NOT_COMPILE_CASE == 10 // TEMPORARY_BOUND_TO_COROUTINE_REFERENCE
+	declaredCoroutine(keyDeclaredLabel = std::string("label"));
+#elif THIS_WILL_NOT_COMPILE_CASE == 11 // MISSING_KEY
+	// missing key in a call with an OptionSet
+	ret = func(0, options, keyC = 3.0);
+#elif THIS_WILL_NOT_COMPILE_CASE == 12 // INVALID_KEY
+	// invalid key of a template function
+	ret = templateFunc(1, keyINVALID = 5);
+#elif THIS_WILL_NOT_COMPILE_CASE == 13 // Non-const references cannot be passed to sweep
+	// non-const reference shared between the threads of a sweep
+	NamedParams::sweep(func, keyA = {1, 2}, keyB = b, keyC = 3.0);
+#elif THIS_WILL_NOT_COMPILE_CASE == 14 // SAME_KEY_PASSED_MORE_THAN_ONCE
+	// member keys: duplicate
+	NamedParams::np_update(settings, keyMaxIter = 1, keyScaling = 1.0, keyMaxIter = 2);
+#elif THIS_WILL_NOT_COMPILE_CASE == 15 // INVALID_KEY
+	// member keys: not a member key
+	NamedParams::np_update(settings, keyMaxIter = 1, keyA = 1);
+#elif THIS_WILL_NOT_COMPILE_CASE == 16 // MISSING_KEY
+	// missing member
+	Aggregate agg = NamedParams::np_init<Aggregate>(Aggregate::keyMemberB = 1);
+#endif
 
-	return 0;
+	return ret;
 }
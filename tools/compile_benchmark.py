@@ -0,0 +1,43 @@
+# PYTHON SCRIPT FOR THE COMPILE-TIME BENCHMARK:
+# configures a separate build directory with NAMEDPARAMS_COMPILE_BENCHMARK=ON and measures
+# the time needed to build each variant of the generated translation units from scratch
+#
+# usage: python3 tools/compile_benchmark.py [build directory] [number of units] [jobs] [ON|OFF]
+
+import os
+import subprocess
+import sys
+import time
+
+SOURCE_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BUILD_DIR = sys.argv[1] if len(sys.argv) > 1 else os.path.join(SOURCE_DIR, "_compile_benchmark")
+NB_UNITS = sys.argv[2] if len(sys.argv) > 2 else "200"
+NB_JOBS = sys.argv[3] if len(sys.argv) > 3 else str(os.cpu_count())
+
+# header units are only supported with GCC, pass OFF as fourth argument for other compilers
+HEADER_UNIT = sys.argv[4] if len(sys.argv) > 4 else "ON"
+
+TARGETS = ["CompileBenchmarkInclude", "CompileBenchmarkPch", "CompileBenchmarkShared", 
+           "CompileBenchmarkDeclared"]
+if HEADER_UNIT == "ON":
+    TARGETS.append("CompileBenchmarkHeaderUnit")
+
+def run(args):
+    subprocess.run(args, check=True, stdout=subprocess.DEVNULL)
+
+run(["cmake", "-S", SOURCE_DIR, "-B", BUILD_DIR, 
+     "-DNAMEDPARAMS_COMPILE_BENCHMARK=ON", 
+     "-DNAMEDPARAMS_COMPILE_BENCHMARK_UNITS=" + NB_UNITS,
+     "-DNAMEDPARAMS_HEADER_UNIT=" + HEADER_UNIT])
+
+print("units: " + NB_UNITS + ", jobs: " + NB_JOBS)
+
+for target in TARGETS:
+    try:
+        run(["cmake", "--build", BUILD_DIR, "--target", "clean"])
+        start = time.perf_counter()
+        run(["cmake", "--build", BUILD_DIR, "--target", target, "-j", NB_JOBS])
+        elapsed = time.perf_counter() - start
+        print("{:<32} {:8.2f} s".format(target, elapsed))
+    except subprocess.CalledProcessError:
+        print("{:<32} {:>8}".format(target, "failed"))